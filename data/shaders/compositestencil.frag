@@ -0,0 +1,19 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#version 450 core
+
+// Video texture, masked by the stencil
+uniform sampler2D colorTexture;
+uniform sampler2D stencilTexture;
+
+in vec2 passUV;
+
+out vec4 out_Color;
+
+void main(void)
+{
+	float mask = texture(stencilTexture, passUV).a;
+	out_Color = vec4(texture(colorTexture, passUV).rgb * mask, mask);
+}
@@ -0,0 +1,32 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#version 450 core
+
+// Extensions
+#extension GL_GOOGLE_include_directive : enable
+
+// Includes
+#include "multivideo.glslinc"
+
+// Video layers are mixed in place of sampling the video texture, see nap::EVideoMode::Fused
+uniform sampler2D stencilTexture;
+
+in vec2 passUV;
+
+out vec4 out_Color;
+
+void main(void)
+{
+	// Layers outside of the stencil are not sampled
+	float mask = texture(stencilTexture, passUV).a;
+	if (mask <= 0.0)
+	{
+		out_Color = vec4(0.0);
+		return;
+	}
+
+	// Video frames are stored top to bottom
+	out_Color = vec4(mixLayers(vec2(passUV.x, 1.0 - passUV.y)) * mask, mask);
+}
@@ -4,25 +4,24 @@
 #extension GL_GOOGLE_include_directive : enable
 
 // Includes
-#include "shadow.glslinc"
+#include "dof.glslinc"
 
 uniform UBO
 {
 	vec2 textureSize;	// The size of 'colorTexture', used to pre-calculate sampling coordinates in vertex shader
 	vec2 direction;		// The sampling direction
-	vec2 nearFar;		// camera near/far planes
-	float aperture;
-	float focusDistance;
-	float focalLength;
-	float focusPower;
 } ubo;
 
 uniform sampler2D colorTexture;		// The input color texture to sample from
-uniform sampler2D depthTexture;		// The input color texture to sample from
+uniform sampler2D cocTexture;		// The circle of confusion of every input pixel
+uniform sampler2D tileTexture;		// The maximum circle of confusion of every tile
 
 in vec2 passUV0;
 out vec4 out_Color;
 
+// Tiles with a smaller maximum blur scale are in focus, the kernel would not reach the neighbouring texel
+const float FOCUS_COC = 0.125 / MAX_COC;
+
 const float weight[] = { 0.2270270270, 0.1945945946, 0.1216216216, 0.0540540541, 0.0162162162 };
 
 
@@ -49,22 +48,16 @@ vec4 blur(sampler2D tx, vec4 col, float s)
 
 void main() 
 {
-	// Adding this small constant to resolve sampling artifacts in cube seams
-	float near = min(ubo.nearFar.x + 0.001, ubo.nearFar.y);
-	float far = ubo.nearFar.y;
-
 	vec4 frag_col = texture(colorTexture, passUV0);
-	float frag_depth = texture(depthTexture, passUV0).x;
-	frag_depth = clamp(frag_depth, near, far);
-	
-	// https://developer.nvidia.com/gpugems/gpugems/part-iv-image-processing/chapter-23-depth-field-survey-techniques
-	float focal = max(ubo.focalLength, near);
-	float focus = max(ubo.focusDistance, near);
 
-	float coc_scale = (ubo.aperture * focal * focus * (far - near)) / ((focus - focal) * near * far);
-	float coc_bias = (ubo.aperture * focal * (near - focus)) / ((focus * focal) * near);
-	float coc = abs(frag_depth * coc_scale + coc_bias);
+	// Skip the kernel for tiles that are fully in focus, the branch is coherent within a tile
+	ivec2 tile = ivec2(passUV0 * vec2(textureSize(tileTexture, 0)));
+	if (texelFetch(tileTexture, tile, 0).x < FOCUS_COC)
+	{
+		out_Color = frag_col;
+		return;
+	}
 
-	out_Color = blur(colorTexture, frag_col, min(pow(coc, max(ubo.focusPower, 1.0)), 4.0));
-	//out_Color = vec4(passUV0.x, passUV0.y, 0.0, 0.0);
+	float s = texture(cocTexture, passUV0).x * MAX_COC;
+	out_Color = blur(colorTexture, frag_col, s);
 }
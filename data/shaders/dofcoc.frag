@@ -0,0 +1,29 @@
+#version 450
+
+// Extensions
+#extension GL_GOOGLE_include_directive : enable
+
+// Includes
+#include "dof.glslinc"
+
+uniform UBO
+{
+	vec2 nearFar;		// camera near/far planes
+	float aperture;
+	float focusDistance;
+	float focalLength;
+	float focusPower;
+} ubo;
+
+uniform sampler2D depthTexture;		// The input depth texture
+
+in vec2 passUV0;
+out vec4 out_Color;
+
+
+void main() 
+{
+	float depth = texture(depthTexture, passUV0).x;
+	float s = computeBlurScale(depth, ubo.nearFar, ubo.aperture, ubo.focalLength, ubo.focusDistance, ubo.focusPower);
+	out_Color = vec4(s / MAX_COC, 0.0, 0.0, 1.0);
+}
@@ -0,0 +1,28 @@
+#version 450
+
+// Extensions
+#extension GL_GOOGLE_include_directive : enable
+
+// Includes
+#include "dof.glslinc"
+
+uniform sampler2D cocTexture;		// The circle of confusion of every input pixel
+
+out vec4 out_Color;
+
+
+void main() 
+{
+	// Maximum of all texels covered by this tile
+	ivec2 size = textureSize(cocTexture, 0);
+	ivec2 origin = ivec2(gl_FragCoord.xy) * TILE_SIZE;
+	ivec2 end = min(origin + TILE_SIZE, size);
+
+	float coc = 0.0;
+	for (int y = origin.y; y < end.y; y++)
+	{
+		for (int x = origin.x; x < end.x; x++)
+			coc = max(coc, texelFetch(cocTexture, ivec2(x, y), 0).x);
+	}
+	out_Color = vec4(coc, 0.0, 0.0, 1.0);
+}
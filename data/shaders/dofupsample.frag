@@ -0,0 +1,52 @@
+#version 450
+
+// Extensions
+#extension GL_GOOGLE_include_directive : enable
+
+// Includes
+#include "dof.glslinc"
+
+uniform sampler2D colorTexture;		// The sharp full resolution color texture
+uniform sampler2D depthTexture;		// The full resolution depth texture
+uniform sampler2D blurTexture;		// The reduced resolution blurred color texture
+uniform sampler2D cocTexture;		// The circle of confusion of every input pixel
+
+in vec2 passUV0;
+out vec4 out_Color;
+
+// Relative depth difference at which a blur texel loses half of its weight
+const float DEPTH_TOLERANCE = 0.02;
+
+
+void main() 
+{
+	vec4 sharp = texture(colorTexture, passUV0);
+	float depth = texture(depthTexture, passUV0).x;
+
+	// Weigh the four nearest blur texels by bilinear weight and depth similarity, avoids halos around in focus edges
+	vec2 blur_size = vec2(textureSize(blurTexture, 0));
+	vec2 pos = passUV0 * blur_size - 0.5;
+	vec2 base = floor(pos);
+	vec2 f = pos - base;
+
+	vec4 blurred = vec4(0.0);
+	float total = 0.0;
+	for (int i = 0; i < 4; i++)
+	{
+		vec2 corner = vec2(i & 1, i >> 1);
+		vec2 uv = (base + corner + 0.5) / blur_size;
+		vec2 bilinear = mix(1.0 - f, f, corner);
+
+		float texel_depth = textureLod(depthTexture, uv, 0.0).x;
+		float difference = abs(texel_depth - depth) / max(depth, 0.0001);
+		float weight = bilinear.x * bilinear.y / (1.0 + difference / DEPTH_TOLERANCE);
+
+		blurred += textureLod(blurTexture, uv, 0.0) * weight;
+		total += weight;
+	}
+	blurred /= max(total, 0.0001);
+
+	// In focus pixels stay sharp
+	float s = texture(cocTexture, passUV0).x * MAX_COC;
+	out_Color = mix(sharp, blurred, clamp(s, 0.0, 1.0));
+}
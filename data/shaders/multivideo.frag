@@ -0,0 +1,20 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#version 450 core
+
+// Extensions
+#extension GL_GOOGLE_include_directive : enable
+
+// Includes
+#include "multivideo.glslinc"
+
+in vec2 passUV;
+
+out vec4 out_Color;
+
+void main(void)
+{
+	out_Color = vec4(mixLayers(passUV), 1.0);
+}
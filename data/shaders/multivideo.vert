@@ -0,0 +1,26 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#version 450 core
+
+uniform nap
+{
+	mat4 projectionMatrix;
+	mat4 viewMatrix;
+	mat4 modelMatrix;
+} mvp;
+
+in vec3	in_Position;
+in vec3	in_UV0;
+
+out vec2 passUV;
+
+void main(void)
+{
+	// Calculate position
+    gl_Position = mvp.projectionMatrix * mvp.viewMatrix * mvp.modelMatrix * vec4(in_Position, 1.0);
+
+	// Pass uv's, video frames are stored top to bottom
+	passUV = vec2(in_UV0.x, 1.0 - in_UV0.y);
+}
@@ -0,0 +1,114 @@
+#version 450 core
+
+// Extensions
+#extension GL_GOOGLE_include_directive : enable
+
+// Total maximum supported number of lights
+#include "maxlights.glslinc"
+
+// Total maximum number of posters in a batch, see nap::RenderPosterBatchComponentInstance::maxPosters
+#define MAX_POSTERS 256
+
+// Includes
+#include "light.glslinc"
+#include "utils.glslinc"
+#include "shadow.glslinc"
+
+// Per poster model matrix
+layout(std430) readonly buffer TransformBuffer
+{
+	mat4 modelMatrices[MAX_POSTERS];
+};
+
+// Per poster texture index (x) and alpha (y)
+layout(std430) readonly buffer InstanceBuffer
+{
+	vec4 instances[MAX_POSTERS];
+};
+
+// Uniforms
+uniform nap
+{
+	mat4 projectionMatrix;
+	mat4 viewMatrix;
+	vec3 cameraPosition;
+} mvp;
+
+uniform shadow
+{
+	mat4 lightViewProjectionMatrix[MAX_LIGHTS];
+	vec2 nearFar[MAX_LIGHTS];
+	float strength[MAX_LIGHTS];
+	float spread[MAX_LIGHTS];
+	uint flags;
+	uint count;
+} sdw;
+
+uniform UBO
+{
+	vec3	ambient;						//< Ambient
+	vec3	diffuse;						//< Diffuse
+	vec3	specular;						//< Specular
+	vec2	fresnel;						//< Fresnel [scale, power]
+	float	shininess;						//< Shininess
+	float	reflection;						//< Reflection
+	float	alpha;							//< Alpha
+	uint	environment;					//< Whether to sample an environment map
+	float	elapsedTime;
+} ubo;
+
+// Vertex Input
+in vec3		in_Position;					//< Vertex position in object space
+in vec3 	in_Normals;						//< Vertex normal in object space
+in vec3 	in_UV0;							//< Texture UVs
+
+// Vertex Output
+out vec3 	passPosition;					//< Vertex position in world space
+out vec3 	passNormal;						//< Vertex normal in world space
+out vec3	passUV0;						//< Texture UVs
+out float 	passFresnel;					//< Fresnel
+out vec4 	passShadowCoords[MAX_LIGHTS];	//< Shadow Coordinates
+out flat uint passTexture;					//< Poster texture index
+out flat float passAlpha;					//< Poster alpha
+
+void main()
+{
+	// Fetch poster, gl_InstanceIndex includes the first instance of the draw
+	mat4 model_matrix = modelMatrices[gl_InstanceIndex];
+	vec4 instance = instances[gl_InstanceIndex];
+	passTexture = uint(instance.x);
+	passAlpha = instance.y;
+
+	// Calculate frag position
+	vec4 world_position = model_matrix * vec4(in_Position, 1.0);
+	gl_Position = mvp.projectionMatrix * mvp.viewMatrix * world_position;
+
+	passPosition = world_position.xyz;
+	passUV0 = in_UV0;
+
+	// Rotate normal based on model matrix and set
+	mat3 normal_matrix = transpose(inverse(mat3(model_matrix)));
+	vec3 world_normal = normalize(normal_matrix * in_Normals);
+	passNormal = world_normal;
+
+	// Compute fresnel contribution
+	vec3 eye_to_surface = normalize(world_position.xyz - mvp.cameraPosition);
+	passFresnel = pow(clamp(1.0 + dot(eye_to_surface, world_normal), 0.0, 1.0), ubo.fresnel.y) * ubo.fresnel.x;
+
+	// Shadow
+	for (uint i = 0; i < min(sdw.count, MAX_LIGHTS); i++)
+	{
+		// Check if shadow is enabled on this light, else skip
+		if (((sdw.flags >> i) & 0x1) != 1)
+			continue;
+
+		// Compute current shadow coordinate: the world position in lightviewspace
+		vec4 coord = sdw.lightViewProjectionMatrix[i] * world_position;
+		
+		// Flip y (Vulkan coordinates are [-1, 1], refer to NAP RenderProjectionMatrix)
+		coord.y = -coord.y;
+		
+		// Pass coordinates
+		passShadowCoords[i] = coord;
+	}
+}
@@ -0,0 +1,26 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#version 450 core
+
+// Extensions
+#extension GL_EXT_nonuniform_qualifier : enable
+
+// Total maximum number of poster textures, see nap::RenderPosterBatchComponentInstance::maxTextures
+#define MAX_TEXTURES 32
+
+in vec2 passUV;
+in flat uint passTexture;
+
+uniform sampler2D colorTextures[MAX_TEXTURES];
+
+const float ALPHA_CLIP = 0.75;
+
+void main(void)
+{
+	if (texture(colorTextures[nonuniformEXT(passTexture)], passUV).a < ALPHA_CLIP)
+		discard;
+
+	gl_FragDepth = gl_FragCoord.z;
+}
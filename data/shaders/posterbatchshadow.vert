@@ -0,0 +1,42 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#version 450 core
+
+// Total maximum number of posters in a batch, see nap::RenderPosterBatchComponentInstance::maxPosters
+#define MAX_POSTERS 256
+
+// Per poster model matrix
+layout(std430) readonly buffer TransformBuffer
+{
+	mat4 modelMatrices[MAX_POSTERS];
+};
+
+// Per poster texture index (x) and alpha (y)
+layout(std430) readonly buffer InstanceBuffer
+{
+	vec4 instances[MAX_POSTERS];
+};
+
+uniform nap
+{
+	mat4 projectionMatrix;
+	mat4 viewMatrix;
+} mvp;
+
+in vec3	in_Position;
+in vec3	in_UV0;
+
+out vec2 passUV;
+out flat uint passTexture;
+
+void main(void)
+{
+	// Calculate position
+    gl_Position = mvp.projectionMatrix * mvp.viewMatrix * modelMatrices[gl_InstanceIndex] * vec4(in_Position, 1.0);
+
+	// Pass uv's and poster texture
+	passUV = in_UV0.xy;
+	passTexture = uint(instances[gl_InstanceIndex].x);
+}
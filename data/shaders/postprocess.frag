@@ -0,0 +1,82 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#version 450 core
+
+// Every operation is specialized on pipeline creation, disabled operations are removed by the compiler
+layout(constant_id = 0) const uint CHANGE_COLOR = 1;	// Adjusts brightness, contrast and saturation of the bloom
+layout(constant_id = 1) const uint BLOOM = 1;			// Screen blends the bloom over the color
+layout(constant_id = 2) const uint ABERRATION = 1;		// Samples the color with chromatic aberration
+layout(constant_id = 3) const uint BRIGHTNESS = 1;		// Adds brightness to the final color
+
+uniform UBO
+{
+	float blend;				// Bloom screen blend amount
+	float abberation;			// Chromatic aberration offset at the corners
+	float brightness;			// Final brightness offset, -1 to 1
+	float bloomBrightness;		// Bloom brightness offset
+	float bloomContrast;		// Bloom contrast multiplier
+	float bloomSaturation;		// Bloom saturation multiplier
+} ubo;
+
+in vec3 pass_UV;
+
+out vec4 out_Color;
+
+// 0: color, 1: blurred bloom source
+uniform sampler2D colorTextures[2];
+
+vec4 chromatic_abberation_sample(sampler2D tex, vec2 uv)
+{
+	const vec2 ctr = { 0.5, 0.5 };
+	vec2 diff = uv - ctr;
+	float intensity = clamp(length(diff), 0.0, 1.0);
+	vec2 d = normalize(diff) * intensity * ubo.abberation;
+
+	vec4 col = vec4(0.0);
+	col.r = texture(tex, uv + d).r;
+	col.ga = texture(tex, uv).ga;
+	col.b = texture(tex, uv - d).b;
+
+	return col;
+}
+
+// Brightness, contrast and saturation are affine and commute with the bloom blur, applying them to the blurred bloom
+// saves a full resolution pass. The result is only clamped after the blur: a color pushed out of range by the adjustment
+// contributes its unclamped value to its neighbours, bright edges bloom slightly wider than when adjusted before the blur.
+vec3 change_color(vec3 color)
+{
+	color = (color - 0.5) * ubo.bloomContrast + 0.5 + ubo.bloomBrightness;
+	float luma = dot(color, vec3(0.2126, 0.7152, 0.0722));
+	return clamp(mix(vec3(luma), color, ubo.bloomSaturation), 0.0, 1.0);
+}
+
+// @param color: input color
+// @param value: [-1, 1] where negative reduces brightness and positive increases it
+vec3 brightness(vec3 color, float value) 
+{
+	return clamp(color + value, 0.0, 1.0);
+} 
+
+void main(void)
+{	
+	vec3 color = ABERRATION != 0 ? chromatic_abberation_sample(colorTextures[0], pass_UV.xy).rgb : texture(colorTextures[0], pass_UV.xy).rgb;
+
+	if (BLOOM != 0)
+	{
+		vec3 bloom = texture(colorTextures[1], pass_UV.xy).rgb;
+		if (CHANGE_COLOR != 0)
+			bloom = change_color(bloom);
+
+		// Blend the screened color into the original based on blend value
+		const vec3 vunit = vec3(1.0, 1.0, 1.0);
+		vec3 screen_color = vunit-(vunit-color)*(vunit-bloom);
+		color = mix(color, screen_color, ubo.blend);
+	}
+
+	if (BRIGHTNESS != 0)
+		color = brightness(color, ubo.brightness);
+
+	out_Color = vec4(color, 1.0);
+}
@@ -8,12 +8,13 @@ in vec2 passUV;
 
 uniform sampler2D colorTexture;
 
+// Disable when the mesh only covers opaque pixels, a shader without discard allows early depth testing
+layout (constant_id = 0) const uint ALPHA_TEST = 1;
+
 const float ALPHA_CLIP = 0.75;
 
 void main(void)
 {
-	if (texture(colorTexture, passUV).a < ALPHA_CLIP)
+	if (ALPHA_TEST != 0 && texture(colorTexture, passUV).a < ALPHA_CLIP)
 		discard;
-
-	gl_FragDepth = gl_FragCoord.z;
 }
@@ -16,6 +16,7 @@
 layout (constant_id = 0) const uint QUAD_SAMPLE_COUNT = 8;
 layout (constant_id = 1) const uint CUBE_SAMPLE_COUNT = 4;
 layout (constant_id = 2) const uint ENABLE_ENVIRONMENT_MAPPING = 1;
+layout (constant_id = 3) const uint ALPHA_TEST = 1;				// Disable when the mesh only covers opaque pixels
 
 // Uniforms
 uniform nap
@@ -79,7 +80,7 @@ void main()
 {
 	// Material color
 	vec4 texture_color = texture(colorTexture, passUV0.xy);
-	if (texture_color.a <= ALPHA_CLIP)
+	if (ALPHA_TEST != 0 && texture_color.a <= ALPHA_CLIP)
 		discard;
 
 	BlinnPhongMaterial mtl = { ubo.ambient, texture_color.rgb * ubo.diffuse, ubo.specular, ubo.shininess };
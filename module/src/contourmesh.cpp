@@ -0,0 +1,180 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+ // Local Includes
+#include "contourmesh.h"
+#include "renderservice.h"
+
+// External Includes
+#include <renderglobals.h>
+#include <nap/core.h>
+#include <nap/logger.h>
+#include <nap/numeric.h>
+#include <mathutils.h>
+#include <cmath>
+
+RTTI_BEGIN_ENUM(nap::EContourFit)
+	RTTI_ENUM_VALUE(nap::EContourFit::Cover,	"Cover"),
+	RTTI_ENUM_VALUE(nap::EContourFit::Inside,	"Inside")
+RTTI_END_ENUM
+
+RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::ContourMesh)
+	RTTI_CONSTRUCTOR(nap::Core&)
+	RTTI_PROPERTY_FILELINK("ImagePath",	&nap::ContourMesh::mImagePath,		nap::rtti::EPropertyMetaData::Required, nap::rtti::EPropertyFileType::Image)
+	RTTI_PROPERTY("AlphaThreshold",		&nap::ContourMesh::mAlphaThreshold,	nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("CellSize",			&nap::ContourMesh::mCellSize,		nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("Fit",				&nap::ContourMesh::mFit,			nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("Size",				&nap::ContourMesh::mSize,			nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("Position",			&nap::ContourMesh::mPosition,		nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("Color",				&nap::ContourMesh::mColor,			nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("Usage",				&nap::ContourMesh::mUsage,			nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("CullMode",			&nap::ContourMesh::mCullMode,		nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("PolygonMode",		&nap::ContourMesh::mPolygonMode,	nap::rtti::EPropertyMetaData::Default)
+RTTI_END_CLASS
+
+
+namespace nap
+{
+	ContourMesh::ContourMesh(Core& core) :
+		mRenderService(core.getService<RenderService>())
+	{ }
+
+
+	bool ContourMesh::trace(const Bitmap& bitmap, float alphaThreshold, int cellSize, EContourFit fit, int& outColumns, int& outRows, std::vector<Rect>& outRects, utility::ErrorState& errorState)
+	{
+		if (!errorState.check(cellSize > 0, "Invalid cell size: %d", cellSize))
+			return false;
+
+		if (!errorState.check(bitmap.getDataType() == ESurfaceDataType::BYTE, "Unsupported bitmap data type, expected 8 bit"))
+			return false;
+
+		const int width = bitmap.getWidth();
+		const int height = bitmap.getHeight();
+		const int channels = bitmap.getNumberOfChannels();
+		outColumns = (width + cellSize - 1) / cellSize;
+		outRows = (height + cellSize - 1) / cellSize;
+		outRects.clear();
+
+		// Without alpha the whole image is opaque
+		if (channels < 4)
+		{
+			outRects.push_back({ 0, 0, outColumns, outRows });
+			return true;
+		}
+
+		// Cover: mark cells that contain at least one pixel that survives the clip
+		// Inside: clear cells that contain at least one pixel that doesn't survive the clip
+		const uint8 threshold = static_cast<uint8>(math::clamp<float>(std::ceil(alphaThreshold * 255.0f), 0.0f, 255.0f));
+		const uint8* data = static_cast<const uint8*>(bitmap.getData());
+		const bool inside = fit == EContourFit::Inside;
+		std::vector<uint8> cells(outColumns * outRows, inside ? 1 : 0);
+		for (int y = 0; y < height; y++)
+		{
+			const uint8* row = data + static_cast<size_t>(y) * width * channels;
+			uint8* cell_row = cells.data() + (y / cellSize) * outColumns;
+			for (int x = 0; x < width; x++)
+			{
+				if ((row[x * channels + 3] >= threshold) != inside)
+					cell_row[x / cellSize] = inside ? 0 : 1;
+			}
+		}
+
+		// Greedily merge opaque cells into rectangles: grow right, then down
+		auto opaque = [&](int x, int y) { return cells[y * outColumns + x] == 1; };
+		for (int y = 0; y < outRows; y++)
+		{
+			for (int x = 0; x < outColumns; x++)
+			{
+				if (!opaque(x, y))
+					continue;
+
+				int rect_width = 1;
+				while (x + rect_width < outColumns && opaque(x + rect_width, y))
+					rect_width++;
+
+				int rect_height = 1;
+				while (y + rect_height < outRows)
+				{
+					bool row_opaque = true;
+					for (int i = x; i < x + rect_width && row_opaque; i++)
+						row_opaque = opaque(i, y + rect_height);
+					if (!row_opaque)
+						break;
+					rect_height++;
+				}
+
+				// Consume the cells
+				for (int j = y; j < y + rect_height; j++)
+					std::fill_n(cells.begin() + j * outColumns + x, rect_width, 2);
+
+				outRects.push_back({ x, y, rect_width, rect_height });
+			}
+		}
+		return true;
+	}
+
+
+	bool ContourMesh::init(utility::ErrorState& errorState)
+	{
+		assert(mRenderService != nullptr);
+
+		Bitmap bitmap(*mRenderService->getCore());
+		if (!bitmap.initFromFile(mImagePath, errorState))
+			return false;
+
+		int columns = 0; int rows = 0;
+		std::vector<Rect> rects;
+		if (!trace(bitmap, mAlphaThreshold, mCellSize, mFit, columns, rows, rects, errorState))
+			return false;
+
+		if (!errorState.check(!rects.empty(), "%s: no pixels above the alpha threshold in %s", mID.c_str(), mImagePath.c_str()))
+			return false;
+
+		// Convert rectangles to quads, bitmap rows and UVs both run bottom to top
+		const glm::vec2 image_size(bitmap.getWidth(), bitmap.getHeight());
+		const glm::vec2 origin = mPosition - mSize * 0.5f;
+		const glm::vec4 color = mColor.toVec4();
+
+		std::vector<glm::vec3> positions;	positions.reserve(rects.size() * 4);
+		std::vector<glm::vec3> uvs;			uvs.reserve(rects.size() * 4);
+		std::vector<uint32> indices;		indices.reserve(rects.size() * 6);
+
+		float covered = 0.0f;
+		for (const auto& rect : rects)
+		{
+			const glm::vec2 min = glm::min(glm::vec2(rect.mX, rect.mY) * static_cast<float>(mCellSize), image_size) / image_size;
+			const glm::vec2 max = glm::min(glm::vec2(rect.mX + rect.mWidth, rect.mY + rect.mHeight) * static_cast<float>(mCellSize), image_size) / image_size;
+			covered += (max.x - min.x) * (max.y - min.y);
+
+			const uint32 first = static_cast<uint32>(positions.size());
+			for (const auto& corner : { glm::vec2(min.x, min.y), glm::vec2(max.x, min.y), glm::vec2(min.x, max.y), glm::vec2(max.x, max.y) })
+			{
+				positions.emplace_back(origin + corner * mSize, 0.0f);
+				uvs.emplace_back(corner, 0.0f);
+			}
+			for (uint32 index : { 0u, 1u, 3u, 0u, 3u, 2u })
+				indices.emplace_back(first + index);
+		}
+		mCoverage = covered;
+
+		// Create mesh instance
+		mMeshInstance = std::make_unique<MeshInstance>(*mRenderService);
+		mMeshInstance->setNumVertices(static_cast<int>(positions.size()));
+		mMeshInstance->setUsage(mUsage);
+		mMeshInstance->setDrawMode(EDrawMode::Triangles);
+		mMeshInstance->setCullMode(mCullMode);
+		mMeshInstance->setPolygonMode(mPolygonMode);
+
+		mMeshInstance->getOrCreateAttribute<glm::vec3>(vertexid::position).setData(positions);
+		mMeshInstance->getOrCreateAttribute<glm::vec3>(vertexid::getUVName(0)).setData(uvs);
+		mMeshInstance->getOrCreateAttribute<glm::vec3>(vertexid::normal).setData(std::vector<glm::vec3>(positions.size(), { 0.0f, 0.0f, 1.0f }));
+		mMeshInstance->getOrCreateAttribute<glm::vec4>(vertexid::getColorName(0)).setData(std::vector<glm::vec4>(positions.size(), color));
+
+		MeshShape& shape = mMeshInstance->createShape();
+		shape.setIndices(indices.data(), indices.size());
+
+		nap::Logger::info("%s: %d triangles, %.1f%% of %s", mID.c_str(), static_cast<int>(indices.size() / 3), mCoverage * 100.0f, mImagePath.c_str());
+		return mMeshInstance->init(errorState);
+	}
+}
@@ -0,0 +1,109 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// External Includes
+#include <mesh.h>
+#include <bitmap.h>
+#include <color.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace nap
+{
+	// Forward Declares
+	class Core;
+	class RenderService;
+
+	/**
+	 * Which cells of the image a nap::ContourMesh covers
+	 */
+	enum class EContourFit : int
+	{
+		Cover	= 0,		///< Cells with at least one opaque pixel, the shader must discard the transparent pixels along the outline
+		Inside	= 1			///< Cells with only opaque pixels, drawn without alpha test
+	};
+
+	/**
+	 * Plane that only covers the opaque part of an image, used in place of a nap::PlaneMesh to draw clipped posters.
+	 *
+	 * The alpha channel of the image is divided into cells of 'CellSize' pixels. A pixel is opaque when its alpha value is
+	 * equal to or above the 'AlphaThreshold'. Opaque cells are merged into as few rectangles as possible, every rectangle is
+	 * drawn as two triangles.
+	 *
+	 * When the 'Fit' is 'Cover' a cell is opaque when at least one of its pixels is opaque. The mesh then contains all pixels
+	 * that survive the alpha clip of the shader, fragments are only discarded along the outline.
+	 * When the 'Fit' is 'Inside' a cell is opaque when all of its pixels are opaque. The mesh then only contains pixels that
+	 * survive the alpha clip, the shader doesn't have to discard: disable the 'ALPHA_TEST' constant of the clip shaders to
+	 * allow early depth testing. The outline is accurate to the cell size, use a cell size of 1 to trace it per pixel.
+	 *
+	 * The vertex layout, positions and UVs match that of a nap::PlaneMesh with the same size and position.
+	 * A smaller cell size results in a tighter fit and more triangles.
+	 */
+	class NAPAPI ContourMesh : public IMesh
+	{
+		RTTI_ENABLE(IMesh)
+	public:
+		/**
+		 * Rectangle in cell coordinates
+		 */
+		struct Rect
+		{
+			int mX = 0;
+			int mY = 0;
+			int mWidth = 0;
+			int mHeight = 0;
+		};
+
+		// Constructor
+		ContourMesh(Core& core);
+
+		/**
+		 * Loads the image and creates the contour mesh
+		 * @param errorState contains the error if the mesh can't be created
+		 * @return if the mesh was created
+		 */
+		virtual bool init(utility::ErrorState& errorState) override;
+
+		/**
+		 * Traces the alpha channel of a bitmap into rectangles.
+		 * Can be called without a mesh, for example to inspect the coverage of an image offline.
+		 * @param bitmap 8 bit bitmap with an alpha channel
+		 * @param alphaThreshold pixels with an alpha value equal to or above this value are opaque, 0-1
+		 * @param cellSize width and height of a cell in pixels
+		 * @param fit if cells with transparent pixels are covered
+		 * @param outColumns number of cell columns
+		 * @param outRows number of cell rows
+		 * @param outRects the merged opaque rectangles, in cell coordinates
+		 * @param errorState contains the error if the bitmap can't be traced
+		 * @return if the bitmap was traced
+		 */
+		static bool trace(const Bitmap& bitmap, float alphaThreshold, int cellSize, EContourFit fit, int& outColumns, int& outRows, std::vector<Rect>& outRects, utility::ErrorState& errorState);
+
+		/**
+		 * @return the fraction of the image that is covered by the mesh, 0-1
+		 */
+		float getCoverage() const											{ return mCoverage; }
+
+		virtual MeshInstance& getMeshInstance() override					{ return *mMeshInstance; }
+		virtual const MeshInstance& getMeshInstance() const override		{ return *mMeshInstance; }
+
+		std::string		mImagePath;									///< Property: 'ImagePath' path to the image to trace
+		float			mAlphaThreshold = 0.75f;					///< Property: 'AlphaThreshold' alpha clip value of the shader, 0-1
+		int				mCellSize = 8;								///< Property: 'CellSize' width and height of a cell in pixels
+		EContourFit		mFit = EContourFit::Cover;					///< Property: 'Fit' if cells with transparent pixels are covered
+		glm::vec2		mSize = { 1.0f, 1.0f };						///< Property: 'Size' the size of the plane
+		glm::vec2		mPosition = { 0.0f, 0.0f };					///< Property: 'Position' center of the plane
+		RGBAColorFloat	mColor = { 1.0f, 1.0f, 1.0f, 1.0f };		///< Property: 'Color' color of the plane
+		EMemoryUsage	mUsage = EMemoryUsage::Static;				///< Property: 'Usage' If the plane is uploaded once or frequently updated.
+		ECullMode		mCullMode = ECullMode::Back;				///< Property: 'CullMode' Plane cull mode, defaults to back
+		EPolygonMode	mPolygonMode = EPolygonMode::Fill;			///< Property: 'PolygonMode' Polygon rasterization mode (fill, line, points)
+
+	private:
+		std::unique_ptr<MeshInstance>	mMeshInstance = nullptr;	///< The mesh instance to construct
+		nap::RenderService*				mRenderService = nullptr;	///< Handle to the render service
+		float							mCoverage = 1.0f;			///< Fraction of the image covered by the mesh
+	};
+}
@@ -1,7 +1,9 @@
 #include "controlbloomcomponent.h"
+#include "lovepostersservice.h"
 
 // External Includes
 #include <entity.h>
+#include <nap/core.h>
 
 // nap::ControlBloomComponent run time class definition 
 RTTI_BEGIN_CLASS(nap::ControlBloomComponent)
@@ -23,6 +25,7 @@ namespace nap
 {
 	bool ControlBloomComponentInstance::init(utility::ErrorState& errorState)
 	{
+		mService = getEntityInstance()->getCore()->getService<LovePostersService>();
 		mResource = getComponent<ControlBloomComponent>();
 
 		auto* uni_struct = mRenderToTextureComponent->getMaterialInstance().getOrCreateUniform("UBO");
@@ -39,6 +42,8 @@ namespace nap
 
 	void ControlBloomComponentInstance::update(double deltaTime)
 	{
+		ProfileScope profile_scope(mService->getUpdateMarker(*this));
+
 		float intensity = (mResource->mIntensityParam != nullptr) ? mResource->mIntensityParam->mValue : 0.0f;
 		float movement = (mResource->mMovementParam != nullptr) ? mResource->mMovementParam->mValue : 1.0f;
 		mBlendUniform->setValue(std::min(mResource->mBaseIntensity + movement * intensity, 1.0f));
@@ -8,6 +8,7 @@
 namespace nap
 {
 	class ControlBloomComponentInstance;
+	class LovePostersService;
 
 	/**
 	 *	ControlBloomComponent
@@ -51,6 +52,7 @@ namespace nap
 
 	private:
 		ControlBloomComponent* mResource = nullptr;
+		LovePostersService* mService = nullptr;		///< Measures the update
 		ComponentInstancePtr<RenderToTextureComponent> mRenderToTextureComponent = { this, &nap::ControlBloomComponent::mRenderToTextureComponent };
 
 		UniformFloatInstance* mBlendUniform = nullptr;
@@ -0,0 +1,299 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "controlrecorder.h"
+
+// External Includes
+#include <nap/logger.h>
+#include <entity.h>
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+namespace nap
+{
+	static constexpr const char* fileMagic = "LPCR";
+	static constexpr uint32 fileVersion = 2;
+	static constexpr uint32 keyRecord = 0xFFFFFFFF;
+
+	/**
+	 * Appends an unsigned integer, least significant byte first
+	 */
+	template<typename T>
+	static void writeValue(std::vector<char>& buffer, T value)
+	{
+		static_assert(std::is_integral<T>::value && std::is_unsigned<T>::value, "unsigned integer expected");
+		for (size_t i = 0; i < sizeof(T); i++)
+			buffer.emplace_back(static_cast<char>((static_cast<uint64>(value) >> (8 * i)) & 0xFF));
+	}
+
+
+	/**
+	 * Appends an IEEE 754 float, least significant byte first
+	 */
+	static void writeValue(std::vector<char>& buffer, float value)
+	{
+		uint32 bits = 0;
+		std::memcpy(&bits, &value, sizeof(bits));
+		writeValue(buffer, bits);
+	}
+
+
+	static void writeString(std::vector<char>& buffer, const std::string& value)
+	{
+		writeValue<uint16>(buffer, static_cast<uint16>(value.size()));
+		buffer.insert(buffer.end(), value.begin(), value.end());
+	}
+
+
+	/**
+	 * Reads an unsigned integer, least significant byte first
+	 */
+	template<typename T>
+	static bool readValue(std::ifstream& file, T& outValue)
+	{
+		static_assert(std::is_integral<T>::value && std::is_unsigned<T>::value, "unsigned integer expected");
+		unsigned char bytes[sizeof(T)];
+		if (!file.read(reinterpret_cast<char*>(bytes), sizeof(T)))
+			return false;
+
+		uint64 value = 0;
+		for (size_t i = 0; i < sizeof(T); i++)
+			value |= static_cast<uint64>(bytes[i]) << (8 * i);
+		outValue = static_cast<T>(value);
+		return true;
+	}
+
+
+	/**
+	 * Reads an IEEE 754 float, least significant byte first
+	 */
+	static bool readValue(std::ifstream& file, float& outValue)
+	{
+		uint32 bits = 0;
+		if (!readValue(file, bits))
+			return false;
+		std::memcpy(&outValue, &bits, sizeof(outValue));
+		return true;
+	}
+
+
+	static bool readString(std::ifstream& file, std::string& outValue)
+	{
+		uint16 length = 0;
+		if (!readValue(file, length))
+			return false;
+		outValue.resize(length);
+		return length == 0 || static_cast<bool>(file.read(outValue.data(), length));
+	}
+
+
+	ControlRecorder::~ControlRecorder()
+	{
+		stop();
+	}
+
+
+	bool ControlRecorder::startRecording(const std::string& path, utility::ErrorState& errorState)
+	{
+		stop();
+		mFile.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!errorState.check(mFile.is_open(), "Unable to open control recording for writing: %s", path.c_str()))
+			return false;
+
+		std::vector<char> header(fileMagic, fileMagic + 4);
+		writeValue(header, fileVersion);
+		mFile.write(header.data(), header.size());
+		mMode = EMode::Record;
+		nap::Logger::info("Recording control inputs to: %s", path.c_str());
+		return true;
+	}
+
+
+	bool ControlRecorder::startReplay(const std::string& path, utility::ErrorState& errorState)
+	{
+		stop();
+		std::ifstream file(path, std::ios::in | std::ios::binary);
+		if (!errorState.check(file.is_open(), "Unable to open control recording: %s", path.c_str()))
+			return false;
+
+		char magic[4];
+		uint32 version = 0;
+		if (!errorState.check(file.read(magic, 4) && std::memcmp(magic, fileMagic, 4) == 0, "%s: not a control recording", path.c_str()))
+			return false;
+
+		if (!errorState.check(readValue(file, version) && version == fileVersion, "%s: unsupported control recording version", path.c_str()))
+			return false;
+
+		// Read keys and events until the end of the file
+		std::vector<std::pair<std::string, std::string>> keys;
+		uint32 frame = 0;
+		while (readValue(file, frame))
+		{
+			if (frame == keyRecord)
+			{
+				uint16 id = 0;
+				std::string source, name;
+				if (!errorState.check(readValue(file, id) && readString(file, source) && readString(file, name), "%s: truncated key", path.c_str()))
+					return false;
+
+				if (keys.size() <= id)
+					keys.resize(id + 1);
+				keys[id] = { source, name };
+				continue;
+			}
+
+			Event event;
+			event.mFrame = frame;
+			uint8 type = 0, count = 0;
+			uint16 key = 0;
+			if (!errorState.check(readValue(file, event.mTime) && readValue(file, type) && readValue(file, key) && readValue(file, count), "%s: truncated event", path.c_str()))
+				return false;
+
+			if (!errorState.check(key < keys.size(), "%s: event references unknown key %d", path.c_str(), key))
+				return false;
+
+			event.mType = static_cast<EEventType>(type);
+			event.mSource = keys[key].first;
+			event.mName = keys[key].second;
+			event.mValues.resize(count);
+			for (auto& value : event.mValues)
+			{
+				if (!errorState.check(readValue(file, value), "%s: truncated event", path.c_str()))
+					return false;
+			}
+			mReplayEvents.emplace_back(std::move(event));
+		}
+
+		mMode = EMode::Replay;
+		nap::Logger::info("Replaying %d control events from: %s", static_cast<int>(mReplayEvents.size()), path.c_str());
+		return true;
+	}
+
+
+	void ControlRecorder::stop()
+	{
+		if (mMode == EMode::Record)
+		{
+			flush();
+			mFile.close();
+		}
+
+		mMode = EMode::Off;
+		mFrame = 0;
+		mTime = 0.0;
+		mKeys.clear();
+		mReplayEvents.clear();
+		mReplayIndex = 0;
+	}
+
+
+	void ControlRecorder::advance(double deltaTime)
+	{
+		switch (mMode)
+		{
+		case EMode::Record:
+			flush();
+			break;
+		case EMode::Replay:
+		{
+			// Emit all events up to and including the new frame
+			uint32 next_frame = mFrame + 1;
+			while (mReplayIndex < mReplayEvents.size() && mReplayEvents[mReplayIndex].mFrame <= next_frame)
+				eventReplayed(mReplayEvents[mReplayIndex++]);
+			break;
+		}
+		default:
+			return;
+		}
+
+		mFrame++;
+		mTime += deltaTime;
+	}
+
+
+	void ControlRecorder::record(EEventType type, const ComponentInstance& component, const std::string& name, std::vector<float> values)
+	{
+		if (mMode != EMode::Record)
+			return;
+
+		// Register source / name pair on first use
+		const std::string source = getInstancePath(component);
+		std::string key_name = source + '\0' + name;
+		auto it = mKeys.find(key_name);
+		if (it == mKeys.end())
+		{
+			uint16 id = static_cast<uint16>(mKeys.size());
+			it = mKeys.emplace(key_name, id).first;
+			writeValue(mBuffer, keyRecord);
+			writeValue(mBuffer, id);
+			writeString(mBuffer, source);
+			writeString(mBuffer, name);
+		}
+
+		writeValue(mBuffer, mFrame);
+		writeValue(mBuffer, static_cast<float>(mTime));
+		writeValue(mBuffer, static_cast<uint8>(type));
+		writeValue(mBuffer, it->second);
+		writeValue(mBuffer, static_cast<uint8>(std::min<size_t>(values.size(), 255)));
+		for (size_t i = 0; i < values.size() && i < 255; i++)
+			writeValue(mBuffer, values[i]);
+	}
+
+
+	bool ControlRecorder::isSource(const Event& event, const ComponentInstance& component)
+	{
+		return event.mSource == getInstancePath(component);
+	}
+
+
+	const ControlRecorder::Event* ControlRecorder::findNextEvent(EEventType type, const ComponentInstance& component, const std::string& name) const
+	{
+		if (mMode != EMode::Replay)
+			return nullptr;
+
+		std::string source = getInstancePath(component);
+		for (size_t i = mReplayIndex; i < mReplayEvents.size(); i++)
+		{
+			const auto& event = mReplayEvents[i];
+			if (event.mType == type && event.mName == name && event.mSource == source)
+				return &event;
+		}
+		return nullptr;
+	}
+
+
+	std::string ControlRecorder::getInstancePath(const ComponentInstance& component)
+	{
+		std::string path = "/" + component.mID;
+		for (const EntityInstance* entity = component.getEntityInstance(); entity != nullptr; entity = entity->getParent())
+		{
+			// Index among the siblings that are instances of the same entity
+			int index = 0;
+			if (const EntityInstance* parent = entity->getParent(); parent != nullptr)
+			{
+				for (const EntityInstance* sibling : parent->getChildren())
+				{
+					if (sibling == entity)
+						break;
+					if (sibling->mID == entity->mID)
+						index++;
+				}
+			}
+			path = "/" + entity->mID + (index > 0 ? ":" + std::to_string(index) : std::string()) + path;
+		}
+		return path;
+	}
+
+
+	void ControlRecorder::flush()
+	{
+		if (!mBuffer.empty())
+		{
+			mFile.write(mBuffer.data(), mBuffer.size());
+			mBuffer.clear();
+		}
+	}
+}
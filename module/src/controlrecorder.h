@@ -0,0 +1,182 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// External Includes
+#include <utility/errorstate.h>
+#include <nap/numeric.h>
+#include <nap/signalslot.h>
+#include <component.h>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace nap
+{
+	/**
+	 * Records time-varying control inputs to a compact binary file and feeds them back frame by frame.
+	 *
+	 * Components report their inputs using record(): OSC events, generated parameter values, playlist switches
+	 * and random seeds. Every event is tagged with the frame it occurred in. In replay mode all events of a frame
+	 * are emitted through the eventReplayed signal in advance(), which is called by the nap::LovePostersService
+	 * before any component is updated. Components should ignore their live inputs while replaying.
+	 *
+	 * Events recorded before the first frame, for example seeds generated on initialization,
+	 * are replayed at the start of the first frame.
+	 *
+	 * Events are keyed by the instance path of the component that produced them, not by the component ID:
+	 * all instances of the same component resource share that ID. Use isSource() to find the events of a component.
+	 *
+	 * File layout, all values are written little endian, independent of the platform:
+	 *
+	 *	header:		'LPCR', uint32 version
+	 *	key:		uint32 0xFFFFFFFF, uint16 id, uint16 length, source, uint16 length, name
+	 *	event:		uint32 frame, float time, uint8 type, uint16 key id, uint8 count, float[count]
+	 */
+	class NAPAPI ControlRecorder final
+	{
+	public:
+		/**
+		 * Recorder mode
+		 */
+		enum class EMode : int
+		{
+			Off			= 0,			///< Inputs are neither recorded or replayed
+			Record		= 1,			///< Inputs are written to file
+			Replay		= 2				///< Inputs are read from file
+		};
+
+		/**
+		 * Type of control event
+		 */
+		enum class EEventType : uint8
+		{
+			Osc			= 0,			///< OSC event, name is the address
+			Parameter	= 1,			///< Parameter value generated by a component
+			Playlist	= 2,			///< Playlist item switch
+			Seed		= 3				///< Random seed
+		};
+
+		/**
+		 * A single control event
+		 */
+		struct Event
+		{
+			uint32				mFrame = 0;				///< Frame the event occurred in
+			float				mTime = 0.0f;			///< Time in seconds since recording started
+			EEventType			mType;					///< Event type
+			std::string			mSource;				///< Instance path of the component that produced the event
+			std::string			mName;					///< Name of the event, for example the osc address
+			std::vector<float>	mValues;				///< Event values
+		};
+
+		~ControlRecorder();
+
+		/**
+		 * Starts recording control inputs to the given file
+		 * @param path the file to write
+		 * @param errorState contains the error if the file can't be created
+		 * @return if recording started
+		 */
+		bool startRecording(const std::string& path, utility::ErrorState& errorState);
+
+		/**
+		 * Loads all control inputs from the given file and starts replaying them
+		 * @param path the file to read
+		 * @param errorState contains the error if the file can't be read
+		 * @return if replay started
+		 */
+		bool startReplay(const std::string& path, utility::ErrorState& errorState);
+
+		/**
+		 * Stops recording or replaying, flushes pending events to disk
+		 */
+		void stop();
+
+		/**
+		 * Advances to the next frame. Writes the events of the previous frame when recording,
+		 * emits the events of the new frame when replaying.
+		 * @param deltaTime time in seconds since the previous frame
+		 */
+		void advance(double deltaTime);
+
+		/**
+		 * Records an event in the current frame, ignored when not recording
+		 * @param type the event type
+		 * @param component the component that produced the event
+		 * @param name name of the event
+		 * @param values event values
+		 */
+		void record(EEventType type, const ComponentInstance& component, const std::string& name, std::vector<float> values);
+
+		/**
+		 * @param event the replayed event
+		 * @param component the component to test
+		 * @return if the event was produced by the instance of the component at the same path
+		 */
+		static bool isSource(const Event& event, const ComponentInstance& component);
+
+		/**
+		 * Finds the next event of the given type and name produced by a component that is yet to be replayed.
+		 * Called from an eventReplayed handler this returns the event after the one being handled.
+		 * @param type the event type
+		 * @param component the component that produced the event
+		 * @param name name of the event
+		 * @return the next event, nullptr when not replaying or when no event follows
+		 */
+		const Event* findNextEvent(EEventType type, const ComponentInstance& component, const std::string& name) const;
+
+		/**
+		 * Returns the path of a component instance in the entity hierarchy, for example '/Scene/Poster:1/Transform'.
+		 * The index following an entity ID distinguishes children that are instances of the same entity.
+		 * @param component the component instance
+		 * @return the instance path of the component
+		 */
+		static std::string getInstancePath(const ComponentInstance& component);
+
+		/**
+		 * @return current mode
+		 */
+		EMode getMode() const								{ return mMode; }
+
+		/**
+		 * @return if inputs are recorded
+		 */
+		bool isRecording() const							{ return mMode == EMode::Record; }
+
+		/**
+		 * @return if inputs are replayed, components should ignore live inputs
+		 */
+		bool isReplaying() const							{ return mMode == EMode::Replay; }
+
+		/**
+		 * @return current frame
+		 */
+		uint32 getFrame() const								{ return mFrame; }
+
+		/**
+		 * @return if all recorded events have been replayed
+		 */
+		bool isReplayFinished() const						{ return mReplayIndex >= mReplayEvents.size(); }
+
+		/**
+		 * Emitted for every event of the current frame when replaying
+		 */
+		Signal<const Event&> eventReplayed;
+
+	private:
+		void flush();
+
+		EMode								mMode = EMode::Off;
+		uint32								mFrame = 0;
+		double								mTime = 0.0;
+		std::ofstream						mFile;
+		std::vector<char>					mBuffer;				///< Pending data of the current frame
+		std::unordered_map<std::string, uint16> mKeys;				///< Registered source/name pairs
+		std::vector<Event>					mReplayEvents;			///< All replay events, ordered by frame
+		size_t								mReplayIndex = 0;		///< Next event to replay
+	};
+}
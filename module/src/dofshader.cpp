@@ -9,13 +9,32 @@
 #include <nap/core.h>
 #include <renderadvancedservice.h>
 
+// nap::BaseDOFShader run time class definition 
+RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::BaseDOFShader)
+RTTI_END_CLASS
+
+// nap::DOFCoCShader run time class definition 
+RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::DOFCoCShader)
+	RTTI_CONSTRUCTOR(nap::Core&)
+RTTI_END_CLASS
+
+// nap::DOFTileShader run time class definition 
+RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::DOFTileShader)
+	RTTI_CONSTRUCTOR(nap::Core&)
+RTTI_END_CLASS
+
 // nap::DOFShader run time class definition 
 RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::DOFShader)
 	RTTI_CONSTRUCTOR(nap::Core&)
 RTTI_END_CLASS
 
+// nap::DOFUpsampleShader run time class definition 
+RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::DOFUpsampleShader)
+	RTTI_CONSTRUCTOR(nap::Core&)
+RTTI_END_CLASS
+
 //////////////////////////////////////////////////////////////////////////
-// DOFShader
+// BaseDOFShader
 //////////////////////////////////////////////////////////////////////////
 
 namespace nap
@@ -23,20 +42,23 @@ namespace nap
 	namespace shader
 	{
 		inline constexpr const char* dof = "dof";
+		inline constexpr const char* dofUpsample = "dofupsample";
+		inline constexpr const char* dofCoC = "dofcoc";
+		inline constexpr const char* dofTile = "doftile";
 	}
 
-    DOFShader::DOFShader(Core& core) :
-		Shader(core), mRenderAdvancedService(core.getService<RenderAdvancedService>())
+    BaseDOFShader::BaseDOFShader(Core& core, const std::string& name) :
+		Shader(core), mRenderAdvancedService(core.getService<RenderAdvancedService>()), mName(name)
 	{ }
 
-    bool DOFShader::init(utility::ErrorState& errorState)
+    bool BaseDOFShader::init(utility::ErrorState& errorState)
     {
 		if (!Shader::init(errorState))
 			return false;
 
-		const std::string display_name = shader::dof;
-		const std::string vertex_shader_path = utility::joinPath({ "shaders", utility::appendFileExtension(display_name, "vert") });
-		const std::string fragment_shader_path = utility::joinPath({ "shaders", utility::appendFileExtension(display_name, "frag") });
+		// All passes draw a full screen triangle
+		const std::string vertex_shader_path = utility::joinPath({ "shaders", utility::appendFileExtension(shader::dof, "vert") });
+		const std::string fragment_shader_path = utility::joinPath({ "shaders", utility::appendFileExtension(mName, "frag") });
 
 		// Read vert shader file
 		std::string vert_source;
@@ -52,10 +74,46 @@ namespace nap
 		const auto search_paths = mRenderAdvancedService->getModule().getInformation().mDataSearchPaths;
 
 		// Parse shader
-		std::string shader_name = utility::getFileNameWithoutExtension(vertex_shader_path);
+		std::string shader_name = utility::getFileNameWithoutExtension(fragment_shader_path);
 		if (!load(shader_name, search_paths, vert_source.data(), vert_source.size(), frag_source.data(), frag_source.size(), errorState))
 			return false;
 
 		return true;
     }
+
+
+	//////////////////////////////////////////////////////////////////////////
+	// DOFCoCShader
+	//////////////////////////////////////////////////////////////////////////
+
+	DOFCoCShader::DOFCoCShader(Core& core) :
+		BaseDOFShader(core, shader::dofCoC)
+	{ }
+
+
+	//////////////////////////////////////////////////////////////////////////
+	// DOFTileShader
+	//////////////////////////////////////////////////////////////////////////
+
+	DOFTileShader::DOFTileShader(Core& core) :
+		BaseDOFShader(core, shader::dofTile)
+	{ }
+
+
+	//////////////////////////////////////////////////////////////////////////
+	// DOFShader
+	//////////////////////////////////////////////////////////////////////////
+
+	DOFShader::DOFShader(Core& core) :
+		BaseDOFShader(core, shader::dof)
+	{ }
+
+
+	//////////////////////////////////////////////////////////////////////////
+	// DOFUpsampleShader
+	//////////////////////////////////////////////////////////////////////////
+
+	DOFUpsampleShader::DOFUpsampleShader(Core& core) :
+		BaseDOFShader(core, shader::dofUpsample)
+	{ }
 }
@@ -24,6 +24,9 @@ namespace nap
 			{	
 				inline constexpr const char* colorTexture	= "colorTexture";		///< Name of the color texture sampler
 				inline constexpr const char* depthTexture	= "depthTexture";		///< Name of the depth texture sampler
+				inline constexpr const char* blurTexture	= "blurTexture";		///< Name of the reduced resolution blur texture sampler
+				inline constexpr const char* cocTexture		= "cocTexture";			///< Name of the circle of confusion texture sampler
+				inline constexpr const char* tileTexture	= "tileTexture";		///< Name of the tile-max circle of confusion texture sampler
 			}
 
 			inline constexpr const char* uboStruct = "UBO";							///< UBO that contains all the uniforms
@@ -37,46 +40,125 @@ namespace nap
 		}
 	}
 
+	namespace dof
+	{
+		inline constexpr int tileSize = 16;											///< Tile width and height of the tile-max circle of confusion texture, must match TILE_SIZE in dof.glslinc
+	}
+
 	/**
-	 * Depth-of-field shader that performs a gaussian blur based on the depth value of a fragment.
-	 * Call this shader twice to sample horizontally (direction = {1.0, 0.0}) and vertically (direction = {0.0, 1.0}).
+	 * Base class of the depth-of-field shaders.
+	 * Loads the full screen triangle vertex shader 'dof.vert' and the fragment shader with the given name.
+	 */
+	class NAPAPI BaseDOFShader : public Shader
+	{
+		RTTI_ENABLE(Shader)
+	public:
+		/**
+		 * @param core the core instance
+		 * @param name name of the fragment shader in the shaders directory, without extension
+		 */
+		BaseDOFShader(Core& core, const std::string& name);
+
+		/**
+		 * Cross compiles the GLSL shader code to SPIR-V, creates the shader module and parses all the uniforms and samplers.
+		 * @param errorState contains the error if initialization fails.
+		 * @return if initialization succeeded.
+		 */
+		virtual bool init(utility::ErrorState& errorState) override;
+
+	private:
+		RenderAdvancedService* mRenderAdvancedService = nullptr;
+		std::string mName;
+	};
+
+
+	/**
+	 * Writes the circle of confusion of every input pixel, computed from the depth texture.
+	 * The blur scale is stored divided by MAX_COC (4), render to a single channel 16 bit target.
 	 *
-	 * The dof shader exposes the following shader variables:
-	 * 
-	 * ~~~~~{.vert}
+	 * ~~~~~{.frag}
 	 *		uniform UBO
 	 *		{
-	 *			vec2 textureSize;				// The size of 'colorTexture', used to pre-calculate sampling coordinates in vertex shader
-	 *			vec2 direction;					// The sampling direction
 	 * 			vec2 nearFar;					// camera near/far planes
 	 *			float aperture;					// Influences the area of focus
 	 *			float focusDistance;			// Distance to focus point
 	 *			float focalLength;				// Focal length
 	 *			float focusPower;				// Additional power over circle of confusion
 	 *		} ubo;
+	 *
+	 * 		uniform sampler2D depthTexture;		// The input depth texture
+	 * ~~~~
+	 */
+	class NAPAPI DOFCoCShader : public BaseDOFShader
+	{
+		RTTI_ENABLE(BaseDOFShader)
+	public:
+	    // Constructor
+		DOFCoCShader(Core& core);
+	};
+
+
+	/**
+	 * Reduces the circle of confusion texture to the maximum of every tile of dof::tileSize texels.
+	 * Render to a target that is dof::tileSize times smaller than the circle of confusion texture, rounded up.
+	 *
+	 * ~~~~~{.frag}
+	 *		uniform sampler2D cocTexture;		// The circle of confusion of every input pixel
 	 * ~~~~
+	 */
+	class NAPAPI DOFTileShader : public BaseDOFShader
+	{
+		RTTI_ENABLE(BaseDOFShader)
+	public:
+	    // Constructor
+		DOFTileShader(Core& core);
+	};
+
+
+	/**
+	 * Depth-of-field shader that performs a gaussian blur based on the circle of confusion of a fragment.
+	 * Call this shader twice to sample horizontally (direction = {1.0, 0.0}) and vertically (direction = {0.0, 1.0}).
+	 * Tiles that are fully in focus skip the kernel.
+	 *
+	 * The dof shader exposes the following shader variables:
+	 * 
+	 * ~~~~~{.frag}
+	 *		uniform UBO
+	 *		{
+	 *			vec2 textureSize;				// The size of 'colorTexture', used to pre-calculate sampling coordinates
+	 *			vec2 direction;					// The sampling direction
+	 *		} ubo;
 	 *
-	 * ~~~~{.frag}
 	 *		uniform sampler2D colorTexture;		// The input color texture to sample from
-	 * 		uniform sampler2D depthTexture;		// The input depth texture to sample from
+	 * 		uniform sampler2D cocTexture;		// The circle of confusion of every input pixel
+	 * 		uniform sampler2D tileTexture;		// The maximum circle of confusion of every tile
 	 * ~~~~
 	 */
-	class NAPAPI DOFShader : public Shader
+	class NAPAPI DOFShader : public BaseDOFShader
 	{
-		RTTI_ENABLE(Shader)
+		RTTI_ENABLE(BaseDOFShader)
 	public:
-
 	    // Constructor
 		DOFShader(Core& core);
+	};
 
-		/**
-		 * Cross compiles the font GLSL shader code to SPIR-V, creates the shader module and parses all the uniforms and samplers.
-		 * @param errorState contains the error if initialization fails.
-		 * @return if initialization succeeded.
-		 */
-		virtual bool init(utility::ErrorState& errorState) override;
 
-	private:
-		RenderAdvancedService* mRenderAdvancedService = nullptr;
+	/**
+	 * Composites a reduced resolution depth-of-field blur with the sharp input at full resolution.
+	 * The four nearest blur texels are weighted by their bilinear weight and depth similarity, in focus pixels stay sharp.
+	 *
+	 * ~~~~~{.frag}
+	 *		uniform sampler2D colorTexture;		// The sharp full resolution color texture
+	 * 		uniform sampler2D depthTexture;		// The full resolution depth texture
+	 * 		uniform sampler2D blurTexture;		// The reduced resolution blurred color texture
+	 * 		uniform sampler2D cocTexture;		// The circle of confusion of every input pixel
+	 * ~~~~
+	 */
+	class NAPAPI DOFUpsampleShader : public BaseDOFShader
+	{
+		RTTI_ENABLE(BaseDOFShader)
+	public:
+	    // Constructor
+		DOFUpsampleShader(Core& core);
 	};
 }
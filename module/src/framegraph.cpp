@@ -0,0 +1,339 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "framegraph.h"
+
+// External Includes
+#include <texture.h>
+#include <nap/logger.h>
+#include <algorithm>
+#include <cassert>
+#include <set>
+
+namespace nap
+{
+	void FrameGraph::addResource(const std::string& name, const Texture2D* texture, bool output)
+	{
+		int idx = findResourceIndex(name);
+		if (idx < 0)
+		{
+			idx = static_cast<int>(mResources.size());
+			mResources.emplace_back();
+			mResources.back().mName = name;
+			mResourceMap.emplace(name, idx);
+		}
+
+		auto& resource = mResources[idx];
+		if (texture != nullptr)
+			resource.mTexture = texture;
+		resource.mOutput |= output;
+		mCompiled = false;
+	}
+
+
+	void FrameGraph::markOutput(const std::string& name)
+	{
+		int idx = findResourceIndex(name);
+		if (idx >= 0)
+		{
+			mResources[idx].mOutput = true;
+			mCompiled = false;
+		}
+	}
+
+
+	FrameGraph::Pass& FrameGraph::addPass(const std::string& name, std::vector<std::string> reads, std::vector<std::string> writes, ExecuteFunction execute)
+	{
+		auto pass = std::make_unique<Pass>();
+		pass->mName = name;
+		pass->mReads = std::move(reads);
+		pass->mWrites = std::move(writes);
+		pass->mExecute = std::move(execute);
+		mPasses.emplace_back(std::move(pass));
+		mCompiled = false;
+		return *mPasses.back();
+	}
+
+
+	bool FrameGraph::compile(utility::ErrorState& errorState)
+	{
+		mCompiled = false;
+		mSchedule.clear();
+		mCulled.clear();
+
+		const int pass_count = static_cast<int>(mPasses.size());
+		const int resource_count = static_cast<int>(mResources.size());
+
+		// Validate names and gather the writers of every resource, in declaration order
+		std::set<std::string> pass_names;
+		std::vector<std::vector<int>> writers(resource_count);
+		for (int i = 0; i < pass_count; i++)
+		{
+			const auto& pass = *mPasses[i];
+			if (!errorState.check(pass_names.emplace(pass.mName).second, "FrameGraph: duplicate pass: %s", pass.mName.c_str()))
+				return false;
+
+			for (const auto& read : pass.mReads)
+			{
+				if (!errorState.check(findResourceIndex(read) >= 0, "FrameGraph: pass '%s' reads unknown resource: %s", pass.mName.c_str(), read.c_str()))
+					return false;
+			}
+
+			for (const auto& write : pass.mWrites)
+			{
+				int idx = findResourceIndex(write);
+				if (!errorState.check(idx >= 0, "FrameGraph: pass '%s' writes unknown resource: %s", pass.mName.c_str(), write.c_str()))
+					return false;
+				writers[idx].emplace_back(i);
+			}
+		}
+
+		// Derive dependencies. Writers of the same resource form a chain in declaration order.
+		// A pass that only reads a resource depends on all of its writers, it observes the final version.
+		std::vector<std::set<int>> dependencies(pass_count);
+		for (int i = 0; i < pass_count; i++)
+		{
+			const auto& pass = *mPasses[i];
+			for (const auto& write : pass.mWrites)
+			{
+				const auto& chain = writers[findResourceIndex(write)];
+				auto it = std::find(chain.begin(), chain.end(), i);
+				if (it != chain.begin())
+					dependencies[i].emplace(*(it - 1));
+			}
+
+			for (const auto& read : pass.mReads)
+			{
+				if (std::find(pass.mWrites.begin(), pass.mWrites.end(), read) != pass.mWrites.end())
+					continue;
+
+				for (int writer : writers[findResourceIndex(read)])
+				{
+					if (writer != i)
+						dependencies[i].emplace(writer);
+				}
+			}
+		}
+
+		// Without an output every pass would be culled, resulting in an empty frame
+		bool has_output = std::any_of(mResources.begin(), mResources.end(), [](const Resource& resource) { return resource.mOutput; });
+		if (!errorState.check(has_output || pass_count == 0, "FrameGraph: no resource is marked as output, all passes would be culled"))
+			return false;
+
+		// Cull passes that do not contribute to an output, walking back from the outputs
+		std::vector<bool> alive(pass_count, false);
+		std::vector<int> stack;
+		for (int i = 0; i < pass_count; i++)
+		{
+			const auto& pass = *mPasses[i];
+			bool writes_output = std::any_of(pass.mWrites.begin(), pass.mWrites.end(), [this](const std::string& write)
+			{
+				return mResources[findResourceIndex(write)].mOutput;
+			});
+
+			if (pass.mSideEffect || writes_output)
+			{
+				alive[i] = true;
+				stack.emplace_back(i);
+			}
+		}
+
+		while (!stack.empty())
+		{
+			int current = stack.back();
+			stack.pop_back();
+			for (int dependency : dependencies[current])
+			{
+				if (!alive[dependency])
+				{
+					alive[dependency] = true;
+					stack.emplace_back(dependency);
+				}
+			}
+		}
+
+		// Topological sort of the alive passes, ties are broken by declaration order
+		std::vector<int> remaining(pass_count, 0);
+		for (int i = 0; i < pass_count; i++)
+		{
+			for (int dependency : dependencies[i])
+				remaining[i] += alive[dependency] ? 1 : 0;
+		}
+
+		std::set<int> ready;
+		int alive_count = 0;
+		for (int i = 0; i < pass_count; i++)
+		{
+			if (!alive[i])
+			{
+				mCulled.emplace_back(mPasses[i].get());
+				continue;
+			}
+
+			alive_count++;
+			if (remaining[i] == 0)
+				ready.emplace(i);
+		}
+
+		std::vector<int> order;
+		while (!ready.empty())
+		{
+			int current = *ready.begin();
+			ready.erase(ready.begin());
+			order.emplace_back(current);
+
+			for (int i = 0; i < pass_count; i++)
+			{
+				if (alive[i] && dependencies[i].find(current) != dependencies[i].end())
+				{
+					if (--remaining[i] == 0)
+						ready.emplace(i);
+				}
+			}
+		}
+
+		if (!errorState.check(static_cast<int>(order.size()) == alive_count, "FrameGraph: cyclic dependency between passes"))
+			return false;
+
+		// Compute resource lifetimes
+		for (auto& resource : mResources)
+			resource.mFirstUse = resource.mLastUse = -1;
+
+		for (int s = 0; s < static_cast<int>(order.size()); s++)
+		{
+			auto* pass = mPasses[order[s]].get();
+			mSchedule.emplace_back(pass);
+
+			auto touch = [this, s](const std::string& name)
+			{
+				auto& resource = mResources[findResourceIndex(name)];
+				if (resource.mFirstUse < 0)
+					resource.mFirstUse = s;
+				resource.mLastUse = s;
+			};
+			std::for_each(pass->mReads.begin(), pass->mReads.end(), touch);
+			std::for_each(pass->mWrites.begin(), pass->mWrites.end(), touch);
+		}
+
+		// Validate aliasing: resources that share a texture must never be alive at the same time.
+		// Outputs live until the end of the frame, resources without a writer carry content in from outside the graph.
+		const int frame_end = static_cast<int>(mSchedule.size());
+		auto live_range = [&](int idx)
+		{
+			const auto& resource = mResources[idx];
+			bool imported = std::none_of(writers[idx].begin(), writers[idx].end(), [&alive](int w) { return alive[w]; });
+			return std::make_pair(imported ? 0 : resource.mFirstUse, resource.mOutput ? frame_end : resource.mLastUse);
+		};
+
+		for (int a = 0; a < resource_count; a++)
+		{
+			for (int b = a + 1; b < resource_count; b++)
+			{
+				const auto& res_a = mResources[a];
+				const auto& res_b = mResources[b];
+				if (res_a.mTexture == nullptr || res_a.mTexture != res_b.mTexture || !res_a.isUsed() || !res_b.isUsed())
+					continue;
+
+				auto range_a = live_range(a);
+				auto range_b = live_range(b);
+				bool overlap = range_a.first <= range_b.second && range_b.first <= range_a.second;
+				if (!errorState.check(!overlap, "FrameGraph: resources '%s' and '%s' share the same texture but are alive at the same time",
+					res_a.mName.c_str(), res_b.mName.c_str()))
+					return false;
+			}
+		}
+
+		mCompiled = true;
+		return true;
+	}
+
+
+	void FrameGraph::execute() const
+	{
+		execute(nullptr, nullptr);
+	}
+
+
+	void FrameGraph::execute(const PassObserver& onBegin, const PassObserver& onEnd) const
+	{
+		assert(mCompiled);
+		for (const auto* pass : mSchedule)
+		{
+			if (!pass->mEnabled || !pass->mExecute)
+				continue;
+
+			if (onBegin)
+				onBegin(*pass);
+
+			pass->mExecute();
+
+			if (onEnd)
+				onEnd(*pass);
+		}
+	}
+
+
+	void FrameGraph::clear()
+	{
+		mPasses.clear();
+		mResources.clear();
+		mResourceMap.clear();
+		mSchedule.clear();
+		mCulled.clear();
+		mCompiled = false;
+	}
+
+
+	FrameGraph::Pass* FrameGraph::findPass(const std::string& name)
+	{
+		auto it = std::find_if(mPasses.begin(), mPasses.end(), [&name](const auto& pass) { return pass->mName == name; });
+		return it != mPasses.end() ? it->get() : nullptr;
+	}
+
+
+	const FrameGraph::Resource* FrameGraph::findResource(const std::string& name) const
+	{
+		int idx = findResourceIndex(name);
+		return idx >= 0 ? &mResources[idx] : nullptr;
+	}
+
+
+	std::vector<std::pair<std::string, std::string>> FrameGraph::getAliasCandidates() const
+	{
+		std::vector<std::pair<std::string, std::string>> candidates;
+		if (!mCompiled)
+			return candidates;
+
+		for (int a = 0; a < static_cast<int>(mResources.size()); a++)
+		{
+			const auto& res_a = mResources[a];
+			if (!res_a.isTransient() || !res_a.isUsed())
+				continue;
+
+			for (int b = a + 1; b < static_cast<int>(mResources.size()); b++)
+			{
+				const auto& res_b = mResources[b];
+				if (!res_b.isTransient() || !res_b.isUsed() || res_a.mTexture == res_b.mTexture)
+					continue;
+
+				bool compatible = res_a.mTexture->getWidth() == res_b.mTexture->getWidth() &&
+					res_a.mTexture->getHeight() == res_b.mTexture->getHeight() &&
+					res_a.mTexture->getFormat() == res_b.mTexture->getFormat();
+
+				bool disjoint = res_a.mLastUse < res_b.mFirstUse || res_b.mLastUse < res_a.mFirstUse;
+				if (compatible && disjoint)
+					candidates.emplace_back(res_a.mName, res_b.mName);
+			}
+		}
+		return candidates;
+	}
+
+
+	int FrameGraph::findResourceIndex(const std::string& name) const
+	{
+		auto it = mResourceMap.find(name);
+		return it != mResourceMap.end() ? it->second : -1;
+	}
+}
@@ -0,0 +1,201 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// External Includes
+#include <utility/errorstate.h>
+#include <nap/numeric.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace nap
+{
+	// Forward declares
+	class Texture2D;
+
+	/**
+	 * Declarative description of the headless render passes of a single frame.
+	 *
+	 * Every pass declares the resources it reads and writes by name. Resources are either bound to a physical
+	 * texture (nap::Texture2D) or virtual, for example the shadow maps managed by the nap::RenderAdvancedService.
+	 * On compile() the graph derives the execution order from the declared dependencies, culls passes that do
+	 * not (indirectly) contribute to an output resource and computes the lifetime of every resource in the schedule.
+	 *
+	 * Multiple passes are allowed to write the same resource, for example when an effect is applied in place.
+	 * Writers of the same resource are executed in declaration order, readers that do not write the resource
+	 * observe the final version of it.
+	 *
+	 * Resources are named after the pass output they hold, not after their texture. Transient resources that never
+	 * live at the same time can share the same physical texture: register them under their own name with the same
+	 * texture pointer. compile() fails when the lifetimes of aliased resources overlap.
+	 * Compatible resources that could be aliased but are not are reported through getAliasCandidates().
+	 * compile() also fails when no resource is marked as output, as every pass would be culled.
+	 *
+	 * Layout transitions and synchronization between passes are handled by the render passes of the
+	 * nap::RenderTarget objects, the graph only guarantees the order in which they are recorded.
+	 *
+	 * ~~~~~{.cpp}
+	 *	mFrameGraph.addResource("Color", &mColorTarget->getColorTexture());
+	 *	mFrameGraph.addResource("DOFIntermediate", &bloomTexture);		// Dead before the bloom is written, shares its texture
+	 *	mFrameGraph.addResource("DOF", &dof->getOutputTexture(), true);
+	 *	mFrameGraph.addResource("Bloom", &bloomTexture, true);
+	 *	mFrameGraph.addPass("Color", {}, { "Color" }, [this]() { ... });
+	 *	mFrameGraph.addPass("DOF", { "Color" }, { "DOFIntermediate", "DOF" }, [dof]() { dof->draw(); });
+	 *	mFrameGraph.addPass("Bloom", { "DOF" }, { "Bloom" }, [bloom]() { bloom->draw(); });
+	 *	if (!mFrameGraph.compile(errorState))
+	 *		return false;
+	 *	...
+	 *	mFrameGraph.execute();
+	 * ~~~~~
+	 */
+	class NAPAPI FrameGraph final
+	{
+	public:
+		struct Pass;
+		using ExecuteFunction = std::function<void()>;
+		using PassObserver = std::function<void(const Pass&)>;
+
+		/**
+		 * A single render pass in the graph
+		 */
+		struct Pass
+		{
+			std::string					mName;						///< Unique name of the pass
+			std::vector<std::string>	mReads;						///< Resources read by this pass
+			std::vector<std::string>	mWrites;					///< Resources written by this pass
+			ExecuteFunction				mExecute;					///< Records the commands of this pass
+			bool						mSideEffect = false;		///< Never culled when set
+			bool						mEnabled = true;			///< Skipped on execute when disabled, without recompiling
+		};
+
+		/**
+		 * A named resource in the graph
+		 */
+		struct Resource
+		{
+			std::string					mName;						///< Unique name of the resource
+			const Texture2D*			mTexture = nullptr;			///< Physical texture, nullptr for virtual resources
+			bool						mOutput = false;			///< If this resource is consumed outside of the graph
+			int							mFirstUse = -1;				///< Index of the first scheduled pass that accesses the resource, -1 when unused
+			int							mLastUse = -1;				///< Index of the last scheduled pass that accesses the resource, -1 when unused
+
+			/**
+			 * @return if the resource is accessed by at least one scheduled pass
+			 */
+			bool isUsed() const										{ return mFirstUse >= 0; }
+
+			/**
+			 * @return if this resource is only used within the frame, i.e. not an output
+			 */
+			bool isTransient() const								{ return !mOutput && mTexture != nullptr; }
+		};
+
+		/**
+		 * Registers a resource. A resource must be registered before it can be referenced by a pass.
+		 * @param name unique name of the resource
+		 * @param texture the physical texture, nullptr for virtual resources
+		 * @param output if the resource is used outside of the graph, for example to present to a window
+		 */
+		void addResource(const std::string& name, const Texture2D* texture, bool output = false);
+
+		/**
+		 * Marks an existing resource as graph output. Passes that do not contribute to an output are culled.
+		 * @param name name of the resource
+		 */
+		void markOutput(const std::string& name);
+
+		/**
+		 * Adds a pass to the graph. The declaration order is only used to order writers of the same resource
+		 * and to break ties between independent passes.
+		 * @param name unique name of the pass
+		 * @param reads resources read by the pass
+		 * @param writes resources written by the pass
+		 * @param execute function that records the pass
+		 * @return the new pass
+		 */
+		Pass& addPass(const std::string& name, std::vector<std::string> reads, std::vector<std::string> writes, ExecuteFunction execute);
+
+		/**
+		 * Derives the pass order, culls unused passes, computes resource lifetimes and validates aliasing.
+		 * Must be called after adding all passes and resources, and again after changing the graph.
+		 * @param errorState contains the error when the graph is invalid
+		 * @return if the graph compiled successfully
+		 */
+		bool compile(utility::ErrorState& errorState);
+
+		/**
+		 * Records all scheduled passes in order.
+		 * Call this in between nap::RenderService::beginHeadlessRecording() and nap::RenderService::endHeadlessRecording().
+		 */
+		void execute() const;
+
+		/**
+		 * Records all scheduled passes in order, invoking the given observers before and after every executed pass.
+		 * Call this in between nap::RenderService::beginHeadlessRecording() and nap::RenderService::endHeadlessRecording().
+		 * @param onBegin called before a pass is recorded
+		 * @param onEnd called after a pass is recorded
+		 */
+		void execute(const PassObserver& onBegin, const PassObserver& onEnd) const;
+
+		/**
+		 * Removes all passes and resources
+		 */
+		void clear();
+
+		/**
+		 * @return if the graph is compiled and ready for execution
+		 */
+		bool isCompiled() const										{ return mCompiled; }
+
+		/**
+		 * Finds a pass by name
+		 * @param name name of the pass
+		 * @return the pass, nullptr if not found
+		 */
+		Pass* findPass(const std::string& name);
+
+		/**
+		 * Finds a resource by name
+		 * @param name name of the resource
+		 * @return the resource, nullptr if not found
+		 */
+		const Resource* findResource(const std::string& name) const;
+
+		/**
+		 * @return the passes that are executed, in order
+		 */
+		const std::vector<Pass*>& getSchedule() const				{ return mSchedule; }
+
+		/**
+		 * @return the passes that are culled because they do not contribute to an output
+		 */
+		const std::vector<Pass*>& getCulledPasses() const			{ return mCulled; }
+
+		/**
+		 * @return all registered resources, including lifetimes after compilation
+		 */
+		const std::vector<Resource>& getResources() const			{ return mResources; }
+
+		/**
+		 * Returns pairs of transient resources that have the same dimensions and format,
+		 * do not overlap in time and are not aliased yet. These can share a single texture.
+		 * @return names of resources that could be aliased
+		 */
+		std::vector<std::pair<std::string, std::string>> getAliasCandidates() const;
+
+	private:
+		int findResourceIndex(const std::string& name) const;
+
+		std::vector<std::unique_ptr<Pass>>		mPasses;			///< All passes in declaration order
+		std::vector<Resource>					mResources;			///< All resources in declaration order
+		std::unordered_map<std::string, int>	mResourceMap;		///< Resource name to index
+		std::vector<Pass*>						mSchedule;			///< Scheduled passes
+		std::vector<Pass*>						mCulled;			///< Culled passes
+		bool									mCompiled = false;	///< If the graph is compiled
+	};
+}
@@ -1,7 +1,9 @@
 #include "funtransformcomponent.h"
+#include "lovepostersservice.h"
 
 // External Includes
 #include <entity.h>
+#include <nap/core.h>
 #include <glm/gtc/noise.hpp>
 #include <glm/gtc/random.hpp>
 
@@ -44,12 +46,15 @@ namespace nap
 
 	bool FunTransformComponentInstance::init(utility::ErrorState& errorState)
 	{
+		mService = getEntityInstance()->getCore()->getService<LovePostersService>();
+
 		mResource = getComponent<FunTransformComponent>();
 		mEnabled = mResource->mEnable;
 
 		mTransformComponent = &getEntityInstance()->getComponent<TransformComponentInstance>();
 		mCachedTransform = std::make_unique<AffineTransform>(*mTransformComponent);
 		mRandomize = mResource->mRandomOffset;
+		mService->getControlRecorder().eventReplayed.connect(mEventReplayedSlot);
 		randomize(mRandomize);
 
 		return true;
@@ -58,7 +63,13 @@ namespace nap
 
 	void FunTransformComponentInstance::randomize(bool enable)
 	{
+		// Seeds are replayed
+		auto& recorder = mService->getControlRecorder();
+		if (recorder.isReplaying())
+			return;
+
 		static const float rand_max = 1000.0f;
+		mRandomSeed = { 0.0f, 0.0f, 0.0f, 0.0f };
 		if (enable)
 		{
 			mRandomSeed = {
@@ -67,14 +78,23 @@ namespace nap
 				glm::linearRand<float>(0.0f, rand_max),
 				glm::linearRand<float>(0.0f, rand_max)
 			};
-			return;
 		}
-		mRandomSeed = { 0.0f, 0.0f, 0.0f, 0.0f };
+		recorder.record(ControlRecorder::EEventType::Seed, *this, "seed", { mRandomSeed.x, mRandomSeed.y, mRandomSeed.z, mRandomSeed.w });
+	}
+
+
+	void FunTransformComponentInstance::onEventReplayed(const ControlRecorder::Event& event)
+	{
+		if (event.mType == ControlRecorder::EEventType::Seed && ControlRecorder::isSource(event, *this) && event.mValues.size() == 4)
+			mRandomSeed = { event.mValues[0], event.mValues[1], event.mValues[2], event.mValues[3] };
 	}
 
 
 	void FunTransformComponentInstance::update(double deltaTime)
 	{
+		ProfileScope profile_scope(mService->getUpdateMarker(*this));
+		deltaTime = mService->getTimeStep(deltaTime);
+
 		if (!mEnabled)
 			return;
 
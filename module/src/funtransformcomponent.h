@@ -7,9 +7,13 @@
 #include <parameternumeric.h>
 
 #include "affinetransform.h"
+#include "controlrecorder.h"
 
 namespace nap
 {
+	// Forward declares
+	class LovePostersService;
+
 	class FunTransformComponentInstance;
 
 	/**
@@ -72,12 +76,18 @@ namespace nap
 		void enable(bool enable) { mEnabled = enable; }
 
 		/**
-		 * 
+		 * Generates a new random seed, or resets it when disabled.
+		 * The seed is recorded, when replaying the recorded seed is used instead.
 		 */
 		void randomize(bool enable);
 
 	private:
+		// Applies a replayed seed
+		void onEventReplayed(const ControlRecorder::Event& event);
+		Slot<const ControlRecorder::Event&> mEventReplayedSlot = { this, &FunTransformComponentInstance::onEventReplayed };
+
 		FunTransformComponent* mResource = nullptr;
+		LovePostersService* mService = nullptr;		///< Provides the time step
 		TransformComponentInstance* mTransformComponent = nullptr;
 
 		std::unique_ptr<AffineTransform> mCachedTransform;
@@ -7,9 +7,7 @@
 #include <entity.h>
 #include <inputservice.h>
 #include <renderservice.h>
-#include <triangleiterator.h>
 #include <renderglobals.h>
-#include <meshutils.h>
 #include <constantshader.h>
 #include <inputcomponent.h>
 
@@ -58,39 +56,37 @@ namespace nap
 	}
 
 
-	static bool findIntersection(const glm::vec3& rayOrig, const glm::vec3& rayDir, const MeshInstance& mesh, const TransformComponentInstance& worldTransform, glm::vec3& outIntersection, glm::vec3& outUV)
+	static glm::vec3 interpolate(const VertexAttribute<glm::vec3>& attribute, const MeshBVH::Hit& hit)
 	{
-		// Create the triangle iterator
-		TriangleIterator it(mesh);
-
-		// Used by intersection call
-		TriangleData<glm::vec3> tri_verts;
+		return attribute[hit.mIndices.x] * hit.mBarycentric.x + attribute[hit.mIndices.y] * hit.mBarycentric.y + attribute[hit.mIndices.z] * hit.mBarycentric.z;
+	}
 
-		// Get atttributes
-		const VertexAttribute<glm::vec3>& verts = mesh.getAttribute<glm::vec3>(vertexid::position);
-		const VertexAttribute<glm::vec3>& uvs = mesh.getAttribute<glm::vec3>(vertexid::getUVName(0));
 
-		while (!it.isDone())
-		{
-			// Use the indices to get the vertex positions
-			Triangle tri = it.next();
+	static bool findIntersection(const glm::vec3& rayOrig, const glm::vec3& rayDir, const MeshInstance& mesh, const TransformComponentInstance& worldTransform, MeshBVH& hierarchy, float& ioDistance, glm::vec3& outIntersection, glm::vec3& outUV)
+	{
+		// Built on first use or when the geometry changed, the check doesn't read the vertices
+		if (!hierarchy.isCurrent(mesh))
+			hierarchy.build(mesh);
+
+		// Skip meshes that are missed or further away than the closest intersection so far
+		const glm::mat4& object_to_world = worldTransform.getGlobalTransform();
+		float entry_distance;
+		if (!hierarchy.getBounds().transform(object_to_world).intersect(rayOrig, 1.0f / rayDir, ioDistance, entry_distance))
+			return false;
 
-			tri_verts[0] = (math::objectToWorld(verts[tri[0]], worldTransform.getGlobalTransform()));
-			tri_verts[1] = (math::objectToWorld(verts[tri[1]], worldTransform.getGlobalTransform()));
-			tri_verts[2] = (math::objectToWorld(verts[tri[2]], worldTransform.getGlobalTransform()));
+		// Transform the ray instead of the vertices, the distance is preserved
+		const glm::mat4 world_to_object = glm::inverse(object_to_world);
+		const glm::vec3 object_orig = world_to_object * glm::vec4(rayOrig, 1.0f);
+		const glm::vec3 object_dir = world_to_object * glm::vec4(rayDir, 0.0f);
 
-			glm::vec3 bary_coord;
-			if (utility::intersect(rayOrig, rayDir, tri_verts, bary_coord))
-			{
-				TriangleData<glm::vec3> tri_vert = tri.getVertexData(verts);
-				outIntersection = utility::interpolateVertexAttr<glm::vec3>(tri_vert, bary_coord);
+		MeshBVH::Hit hit;
+		if (!hierarchy.intersect(object_orig, object_dir, hit, ioDistance))
+			return false;
 
-				TriangleData<glm::vec3> tri_uv = tri.getVertexData(uvs);
-				outUV = utility::interpolateVertexAttr<glm::vec3>(tri_uv, bary_coord);
-				return true;
-			}
-		}
-		return false;
+		ioDistance = hit.mDistance;
+		outIntersection = interpolate(mesh.getAttribute<glm::vec3>(vertexid::position), hit);
+		outUV = interpolate(mesh.getAttribute<glm::vec3>(vertexid::getUVName(0)), hit);
+		return true;
 	}
 
 
@@ -218,6 +214,9 @@ namespace nap
 		if (!errorState.check(!resource->mInteractionGeometries.empty(), "%s: missing interaction geometries", mID.c_str()))
 			return false;
 
+		// Hierarchies are built on first use
+		mHierarchies.resize(mGeometries.size());
+
 		pointer_comp->pressed.connect(std::bind(&GeometryInteractionComponentInstance::onMouseDown, this, std::placeholders::_1));
 		pointer_comp->moved.connect(std::bind(&GeometryInteractionComponentInstance::onMouseMove, this, std::placeholders::_1));
 		pointer_comp->released.connect(std::bind(&GeometryInteractionComponentInstance::onMouseUp, this, std::placeholders::_1));
@@ -242,11 +241,14 @@ namespace nap
 		// World space camera position
 		glm::vec3 cam_pos = math::extractPosition(mCamera->getEntityInstance()->getComponent<TransformComponentInstance>().getGlobalTransform());
 
-		// Find one intersection
+		// Find the closest intersection
 		glm::vec3 intersection, uv;
-		bool intersects = false;
-		for (const auto& geom : mGeometries)
+		float distance = math::max<float>();
+		mIntersects = false;
+		for (int i = 0; i < mGeometries.size(); i++)
 		{
+			const auto& geom = mGeometries[i];
+
 			// Get object to world transformation matrix
 			TransformComponentInstance& world_xform = geom->getEntityInstance()->getComponent<TransformComponentInstance>();
 
@@ -254,20 +256,25 @@ namespace nap
 			auto& mesh_comp = geom->getEntityInstance()->getComponent<RenderableMeshComponentInstance>();
 			const auto& mesh = mesh_comp.getMeshInstance();
 
-			// Perform intersection test, walk over every triangle in the mesh		
-			intersects = findIntersection(cam_pos, screen_to_world_ray, mesh, world_xform, intersection, uv);
-			if (intersects)
+			// Perform intersection test against the hierarchy of the mesh, only closer intersections are accepted
+			if (findIntersection(cam_pos, screen_to_world_ray, mesh, world_xform, mHierarchies[i], distance, intersection, uv))
 			{
-				mIntersects = intersects;
+				mIntersects = true;
 				mIntersectionWorldPosition = intersection;
 				mIntersectionUV = uv;
 				mIntersectionGeometry = static_cast<RenderableMeshComponentInstance*>(geom->get_ptr());
-				break;
 			}
 		}
 	}
 
 
+	void GeometryInteractionComponentInstance::invalidate()
+	{
+		for (auto& hierarchy : mHierarchies)
+			hierarchy = MeshBVH();
+	}
+
+
 	void GeometryInteractionComponentInstance::onMouseDown(const PointerPressEvent& pressEvent)
 	{
 		mMousePressed = true;
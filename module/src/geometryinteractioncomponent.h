@@ -1,5 +1,8 @@
 #pragma once
 
+// Local includes
+#include "meshbvh.h"
+
 // External includes
 #include <renderablemeshcomponent.h>
 #include <cameracomponent.h>
@@ -60,6 +63,12 @@ namespace nap
 		 */
 		bool getIntersectionData(RenderableMeshComponentInstance* outComp, glm::vec3& outPosition, glm::vec3& outUV) const;
 
+		/**
+		 * Rebuilds the picking hierarchy of every geometry on the next pointer move.
+		 * Call after editing the vertex positions or indices of a geometry in place, see nap::MeshBVH::isCurrent().
+		 */
+		void invalidate();
+
 	private:
 		RenderService* mRenderService = nullptr;
 
@@ -73,6 +82,7 @@ namespace nap
 
 		ComponentInstancePtr<CameraComponent> mCamera = { this, &nap::GeometryInteractionComponent::mCamera };
 		std::vector<ComponentInstancePtr<RenderableMeshComponent>> mGeometries = initComponentInstancePtr(this, &nap::GeometryInteractionComponent::mInteractionGeometries);
+		std::vector<MeshBVH> mHierarchies;		///< Picking hierarchy of every geometry, built on demand
 
 		bool									mIntersects = false;
 		glm::vec3								mIntersectionWorldPosition;
@@ -3,6 +3,7 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
 
 #include "legacyfluxmeasurementcomponent.h"
+#include "lovepostersservice.h"
 #include "fftaudionodecomponent.h"
 #include "fftutils.h"
 
@@ -59,6 +60,8 @@ namespace nap
 
 	bool LegacyFluxMeasurementComponentInstance::init(utility::ErrorState& errorState)
 	{
+		mService = getEntityInstance()->getCore()->getService<LovePostersService>();
+
 		// Fetch resource
 		mResource = getComponent<LegacyFluxMeasurementComponent>();
 
@@ -78,13 +81,19 @@ namespace nap
 		}
 
 		mPreviousBuffer.resize(bin_count);
+
+		// Generated values are replaced by recorded values on replay
+		mService->getControlRecorder().eventReplayed.connect(mEventReplayedSlot);
 		return true;
 	}
 
 
 	void LegacyFluxMeasurementComponentInstance::update(double deltaTime)
 	{
-		if (!mResource->mEnable)
+		ProfileScope profile_scope(mService->getUpdateMarker(*this));
+		deltaTime = mService->getTimeStep(deltaTime);
+
+		if (!mResource->mEnable || mService->getControlRecorder().isReplaying())
 			return;
 
 		const float delta_time = static_cast<float>(deltaTime);
@@ -128,7 +137,7 @@ namespace nap
 				float average_onset = std::max(entry.computeMovingAverage(onset, entry.mSampleAverage), glm::epsilon<float>()*2.0f);
 				float target_onset = (entry.mTargetOnset != nullptr) ? entry.mTargetOnset->mValue : 0.25f;
 				float factor = target_onset / average_onset;
-				entry.mStretch->setValue(entry.mStretchSmoother.update(factor, delta_time));
+				setParameter(*entry.mStretch, entry.mStretchSmoother.update(factor, delta_time));
 				stretch = entry.mStretch->mValue;
 			}
 
@@ -136,7 +145,7 @@ namespace nap
 			float smooth_onset = entry.mOnsetSmoother.update(entry.mOnsetValue, delta_time);
 			float stretch_onset = smooth_onset * stretch;
 			float offset = (entry.mOffset != nullptr) ? entry.mOffset->mValue : 0.0f;
-			entry.mParameter.setValue(stretch_onset + offset);
+			setParameter(entry.mParameter, stretch_onset + offset);
 		}
 
 		// Copy
@@ -144,6 +153,28 @@ namespace nap
 	}
 
 
+	void LegacyFluxMeasurementComponentInstance::setParameter(ParameterFloat& parameter, float value)
+	{
+		parameter.setValue(value);
+		mService->getControlRecorder().record(ControlRecorder::EEventType::Parameter, *this, parameter.mID, { value });
+	}
+
+
+	void LegacyFluxMeasurementComponentInstance::onEventReplayed(const ControlRecorder::Event& event)
+	{
+		if (event.mType != ControlRecorder::EEventType::Parameter || !ControlRecorder::isSource(event, *this) || event.mValues.empty())
+			return;
+
+		for (auto& entry : mOnsetList)
+		{
+			if (entry.mParameter.mID == event.mName)
+				entry.mParameter.setValue(event.mValues[0]);
+			else if (entry.mStretch != nullptr && entry.mStretch->mID == event.mName)
+				entry.mStretch->setValue(event.mValues[0]);
+		}
+	}
+
+
 	//////////////////////////////////////////////////////////////////////////
 	// LegacyFluxMeasurementComponentInstance::OnsetData
 	//////////////////////////////////////////////////////////////////////////
@@ -5,6 +5,7 @@
 #pragma once
 
 // Local includes
+#include "controlrecorder.h"
 #include "fftutils.h"
 
 // Nap includes
@@ -14,6 +15,9 @@
 
 namespace nap
 {
+	// Forward declares
+	class LovePostersService;
+
 	class LegacyFluxMeasurementComponentInstance;
 	class FFTAudioNodeComponentInstance;
 			
@@ -132,7 +136,17 @@ namespace nap
 		const std::vector<rtti::ObjectPtr<LegacyFluxMeasurementComponent::FilterParameterItem>>& getParameterItems() const { return mResource->mParameters; }
 
 	private:
+		/**
+		 * Applies a replayed parameter value, the flux is not computed while replaying
+		 */
+		void onEventReplayed(const ControlRecorder::Event& event);
+		Slot<const ControlRecorder::Event&> mEventReplayedSlot = { this, &LegacyFluxMeasurementComponentInstance::onEventReplayed };
+
+		// Sets the value of a parameter and records it
+		void setParameter(ParameterFloat& parameter, float value);
+
 		LegacyFluxMeasurementComponent* mResource = nullptr;
+		LovePostersService* mService = nullptr;		///< Provides the time step
 		FFTAudioNodeComponentInstance* mFFTAudioComponent = nullptr;
 
 		std::vector<OnsetData> mOnsetList;
@@ -1,7 +1,9 @@
 #include "levelmeterparametercomponent.h"
+#include "lovepostersservice.h"
 
 // External Includes
 #include <entity.h>
+#include <nap/core.h>
 
 // nap::LevelMeterParameterComponent run time class definition 
 RTTI_BEGIN_CLASS(nap::LevelMeterParameterComponent)
@@ -29,16 +31,36 @@ namespace nap
 
 	bool LevelMeterParameterComponentInstance::init(utility::ErrorState& errorState)
 	{
+		mService = getEntityInstance()->getCore()->getService<LovePostersService>();
+
 		mResource = getComponent<LevelMeterParameterComponent>();
 		mLevelSmoother.mSmoothTime = mResource->mSmoothtime;
+
+		// Measured levels are replaced by recorded levels on replay
+		mService->getControlRecorder().eventReplayed.connect(mEventReplayedSlot);
 		return true;
 	}
 
 
 	void LevelMeterParameterComponentInstance::update(double deltaTime)
 	{
+		ProfileScope profile_scope(mService->getUpdateMarker(*this));
+		deltaTime = mService->getTimeStep(deltaTime);
+
+		auto& recorder = mService->getControlRecorder();
+		if (recorder.isReplaying())
+			return;
+
 		float multiply = mResource->mMultiplyParam != nullptr ? mResource->mMultiplyParam->mValue : 1.0f;
 		float level = mLevelSmoother.update(mLevelMeter->getLevel() * multiply, static_cast<float>(deltaTime));
 		mResource->mLevelMeterParam->setValue(level);
+		recorder.record(ControlRecorder::EEventType::Parameter, *this, mResource->mLevelMeterParam->mID, { level });
+	}
+
+
+	void LevelMeterParameterComponentInstance::onEventReplayed(const ControlRecorder::Event& event)
+	{
+		if (event.mType == ControlRecorder::EEventType::Parameter && ControlRecorder::isSource(event, *this) && !event.mValues.empty())
+			mResource->mLevelMeterParam->setValue(event.mValues[0]);
 	}
 }
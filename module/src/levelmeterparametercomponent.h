@@ -7,8 +7,13 @@
 
 #include <audio/component/levelmetercomponent.h>
 
+#include "controlrecorder.h"
+
 namespace nap
 {
+	// Forward declares
+	class LovePostersService;
+
 	class LevelMeterParameterComponentInstance;
 
 	/**
@@ -60,8 +65,15 @@ namespace nap
 		ComponentInstancePtr<audio::LevelMeterComponent> mLevelMeter = { this, &nap::LevelMeterParameterComponent::mLevelMeter };
 
 		LevelMeterParameterComponent* mResource = nullptr;
+		LovePostersService* mService = nullptr;		///< Provides the time step
 
 	private:
+		/**
+		 * Applies a replayed level, the level is not measured while replaying
+		 */
+		void onEventReplayed(const ControlRecorder::Event& event);
+		Slot<const ControlRecorder::Event&> mEventReplayedSlot = { this, &LevelMeterParameterComponentInstance::onEventReplayed };
+
 		math::SmoothOperator<float> mLevelSmoother{ 0.0f, 0.0f };
 	};
 }
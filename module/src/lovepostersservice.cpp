@@ -4,11 +4,23 @@
 #include "audiodevicesettingsgui.h"
 #include "infowindow.h"
 #include "fftwindow.h"
+#include "profilerwindow.h"
 
 // External Includes
 #include <parameterguiservice.h>
 #include <appguiservice.h>
+#include <renderservice.h>
+#include <sceneservice.h>
+#include <component.h>
 #include <nap/core.h>
+#include <utility/fileutils.h>
+#include <utility/stringutils.h>
+
+RTTI_BEGIN_CLASS(nap::LovePostersServiceConfiguration)
+	RTTI_PROPERTY("RecordFile",			&nap::LovePostersServiceConfiguration::mRecordFile,			nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("ReplayFile",			&nap::LovePostersServiceConfiguration::mReplayFile,			nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("PipelineCacheFile",	&nap::LovePostersServiceConfiguration::mPipelineCacheFile,	nap::rtti::EPropertyMetaData::Default)
+RTTI_END_CLASS
 
 RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::LovePostersService)
 	RTTI_CONSTRUCTOR(nap::ServiceConfiguration*)
@@ -18,14 +30,81 @@ namespace nap
 {
 	bool LovePostersService::init(nap::utility::ErrorState& errorState)
 	{
+		mProfiler = std::make_unique<Profiler>(*getCore().getService<RenderService>());
+		if (!mProfiler->init(errorState))
+			return false;
+		mSceneMarker = mProfiler->registerMarker("update: scene", Profiler::EDomain::CPU);
+
+		// Load the pipelines of previous runs before any resource is created
+		auto* config = getConfiguration<LovePostersServiceConfiguration>();
+		std::string cache_file = config != nullptr ? config->mPipelineCacheFile : std::string();
+		if (cache_file.empty())
+			cache_file = utility::joinPath({ utility::getExecutableDir(), "cache", "pipelines.bin" });
+
+		mPipelineCache = std::make_unique<PipelineCache>(*getCore().getService<RenderService>());
+		if (!mPipelineCache->init(cache_file, errorState))
+			return false;
+
+		// Start recording or replaying control inputs before any component is created
+		if (config != nullptr)
+		{
+			if (!config->mReplayFile.empty())
+			{
+				if (!mControlRecorder.startReplay(config->mReplayFile, errorState))
+					return false;
+			}
+			else if (!config->mRecordFile.empty())
+			{
+				if (!mControlRecorder.startRecording(config->mRecordFile, errorState))
+					return false;
+			}
+		}
+
         return true;
 	}
 
 
+	void LovePostersService::preUpdate(double deltaTime)
+	{
+		mControlRecorder.advance(getTimeStep(deltaTime));
+		mSceneUpdateStart = std::chrono::high_resolution_clock::now();
+	}
+
+
+	void LovePostersService::update(double deltaTime)
+	{
+		std::chrono::duration<float, std::milli> elapsed = std::chrono::high_resolution_clock::now() - mSceneUpdateStart;
+		mProfiler->addSample(mSceneMarker, elapsed.count());
+	}
+
+
+	ProfileMarker LovePostersService::getUpdateMarker(const ComponentInstance& component)
+	{
+		const rtti::TypeInfo type = component.get_type();
+		auto it = mUpdateMarkers.find(type.get_id());
+		if (it == mUpdateMarkers.end())
+		{
+			const std::string name = utility::stringFormat("update: %s", type.get_name().to_string().c_str());
+			it = mUpdateMarkers.emplace(type.get_id(), mProfiler->registerMarker(name, Profiler::EDomain::CPU)).first;
+		}
+		return it->second;
+	}
+
+
+	void LovePostersService::shutdown()
+	{
+		mControlRecorder.stop();
+		mPipelineCache->shutdown();
+		mProfiler->shutdown();
+	}
+
+
 	void LovePostersService::getDependentServices(std::vector<rtti::TypeInfo>& dependencies)
 	{
         dependencies.emplace_back(RTTI_OF(ParameterGUIService));
         dependencies.emplace_back(RTTI_OF(audio::AudioService));
+        dependencies.emplace_back(RTTI_OF(RenderService));
+        dependencies.emplace_back(RTTI_OF(SceneService));
 	}
 
 
@@ -36,5 +115,6 @@ namespace nap
         factory.addObjectCreator(std::make_unique<FFTWindowObjectCreator>(*appgui_service));
         factory.addObjectCreator(std::make_unique<ParameterWindowObjectCreator>(*appgui_service));
         factory.addObjectCreator(std::make_unique<audio::AudioDeviceSettingsWindowObjectCreator>(*appgui_service));
+        factory.addObjectCreator(std::make_unique<ProfilerWindowObjectCreator>(*appgui_service));
     }
 }
@@ -3,9 +3,37 @@
 // External Includes
 #include <nap/service.h>
 #include <parametergroup.h>
+#include <chrono>
+#include <unordered_map>
+
+// Local Includes
+#include "profiler.h"
+#include "controlrecorder.h"
+#include "pipelinecache.h"
 
 namespace nap
 {
+	// Forward declares
+	class LovePostersService;
+	class ComponentInstance;
+
+	/**
+	 * LovePosters service configuration, selects control input recording or replay.
+	 * When a replay file is given it takes precedence over the record file.
+	 * The compute pipelines of this module are cached in the 'PipelineCacheFile', see nap::PipelineCache.
+	 */
+	class NAPAPI LovePostersServiceConfiguration : public ServiceConfiguration
+	{
+		RTTI_ENABLE(ServiceConfiguration)
+	public:
+		std::string mRecordFile;				///< Property: 'RecordFile' file to record control inputs to, empty to disable
+		std::string mReplayFile;				///< Property: 'ReplayFile' file to replay control inputs from, empty to disable
+		std::string mPipelineCacheFile;			///< Property: 'PipelineCacheFile' pipeline cache file, cache/pipelines.bin next to the executable when empty
+
+		virtual rtti::TypeInfo getServiceType() const override	{ return RTTI_OF(LovePostersService); }
+	};
+
+
 	class NAPAPI LovePostersService : public Service
 	{
 		RTTI_ENABLE(Service)
@@ -28,7 +56,80 @@ namespace nap
 		 */
 		virtual bool init(nap::utility::ErrorState& errorState) override;
 
+		/**
+		 * Advances the control recorder, replayed inputs are dispatched before components are updated.
+		 * Starts measuring the update of the scene.
+		 * @param deltaTime time in seconds in between frames
+		 */
+		virtual void preUpdate(double deltaTime) override;
+
+		/**
+		 * Stops measuring the update of the scene. This service depends on the nap::SceneService, which updates all
+		 * entities and components before this call. The 'update: scene' marker is the total, including the update of
+		 * services that are ordered in between. The components of this module are measured per type, see getUpdateMarker().
+		 * @param deltaTime time in seconds in between frames
+		 */
+		virtual void update(double deltaTime) override;
+
+		/**
+		 * Destroys the profiler resources, writes the pipeline cache and closes the control recording
+		 */
+		virtual void shutdown() override;
+
+		/**
+		 * @return the profiler that collects CPU and GPU timings
+		 */
+		Profiler& getProfiler()									{ return *mProfiler; }
+
+		/**
+		 * Returns the CPU marker that measures the update of all components of the same type, registered on first request.
+		 * Measure the update of a component with a nap::ProfileScope:
+		 *
+		 * ~~~~~{.cpp}
+		 *	void MyComponentInstance::update(double deltaTime)
+		 *	{
+		 *		ProfileScope profile_scope(mService->getUpdateMarker(*this));
+		 *		...
+		 *	}
+		 * ~~~~~
+		 * @param component the component to measure
+		 * @return the 'update: <type>' marker of the type of the component
+		 */
+		ProfileMarker getUpdateMarker(const ComponentInstance& component);
+
+		/**
+		 * @return the recorder that captures or replays the control inputs of this module
+		 */
+		ControlRecorder& getControlRecorder()					{ return mControlRecorder; }
+
+		/**
+		 * @return the persistent cache the compute pipelines of this module are created with
+		 */
+		PipelineCache& getPipelineCache()						{ return *mPipelineCache; }
+
+		/**
+		 * Forces all components of this module to advance with a fixed time step, for reproducible offline rendering.
+		 * @param seconds the time step in seconds, 0 to use the frame time
+		 */
+		void setFixedTimeStep(double seconds)					{ mFixedTimeStep = seconds; }
+
+		/**
+		 * Returns the time step components of this module advance with.
+		 * @param deltaTime the time in seconds in between frames
+		 * @return the fixed time step when set, otherwise the given delta time
+		 */
+		double getTimeStep(double deltaTime) const				{ return mFixedTimeStep > 0.0 ? mFixedTimeStep : deltaTime; }
+
     protected:
         void registerObjectCreators(rtti::Factory &factory) override;
+
+	private:
+		std::unique_ptr<Profiler> mProfiler;
+		std::unique_ptr<PipelineCache> mPipelineCache;
+		ProfileMarker mSceneMarker;																///< CPU time of the scene update
+		std::unordered_map<rtti::TypeInfo::type_id, ProfileMarker> mUpdateMarkers;				///< CPU time of the update per component type
+		std::chrono::high_resolution_clock::time_point mSceneUpdateStart;						///< Start of the scene update
+		ControlRecorder mControlRecorder;
+		double mFixedTimeStep = 0.0;
 	};
 }
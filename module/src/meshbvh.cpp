@@ -0,0 +1,224 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "meshbvh.h"
+
+// External Includes
+#include <renderglobals.h>
+#include <triangleiterator.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace nap
+{
+	static constexpr uint32 maxLeafSize = 4;
+	static constexpr int maxDepth = 64;
+
+
+	/**
+	 * Number of indices of all shapes
+	 */
+	static uint32 countIndices(const MeshInstance& mesh)
+	{
+		size_t count = 0;
+		for (int i = 0; i < mesh.getNumShapes(); i++)
+			count += mesh.getShape(i).getIndices().size();
+		return static_cast<uint32>(count);
+	}
+
+
+	/**
+	 * Two sided ray triangle intersection, Moller and Trumbore
+	 */
+	static bool intersectTriangle(const glm::vec3& origin, const glm::vec3& direction, const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2, float& outDistance, glm::vec2& outUV)
+	{
+		const glm::vec3 edge1 = v1 - v0;
+		const glm::vec3 edge2 = v2 - v0;
+		const glm::vec3 p = glm::cross(direction, edge2);
+		const float det = glm::dot(edge1, p);
+		if (std::abs(det) < std::numeric_limits<float>::epsilon())
+			return false;
+
+		const float inv_det = 1.0f / det;
+		const glm::vec3 s = origin - v0;
+		const float u = glm::dot(s, p) * inv_det;
+		if (u < 0.0f || u > 1.0f)
+			return false;
+
+		const glm::vec3 q = glm::cross(s, edge1);
+		const float v = glm::dot(direction, q) * inv_det;
+		if (v < 0.0f || u + v > 1.0f)
+			return false;
+
+		outDistance = glm::dot(edge2, q) * inv_det;
+		outUV = { u, v };
+		return outDistance >= 0.0f;
+	}
+
+
+	MeshBVH::Bounds MeshBVH::Bounds::transform(const glm::mat4& matrix) const
+	{
+		Bounds bounds;
+		for (int i = 0; i < 8; i++)
+		{
+			const glm::vec3 corner = { (i & 1) ? mMax.x : mMin.x, (i & 2) ? mMax.y : mMin.y, (i & 4) ? mMax.z : mMin.z };
+			bounds.extend(glm::vec3(matrix * glm::vec4(corner, 1.0f)));
+		}
+		return bounds;
+	}
+
+
+	bool MeshBVH::Bounds::intersect(const glm::vec3& origin, const glm::vec3& invDirection, float maxDistance, float& outDistance) const
+	{
+		const glm::vec3 t0 = (mMin - origin) * invDirection;
+		const glm::vec3 t1 = (mMax - origin) * invDirection;
+		const glm::vec3 t_near = glm::min(t0, t1);
+		const glm::vec3 t_far = glm::max(t0, t1);
+
+		outDistance = glm::max(glm::max(t_near.x, t_near.y), glm::max(t_near.z, 0.0f));
+		return outDistance <= glm::min(glm::min(t_far.x, t_far.y), glm::min(t_far.z, maxDistance));
+	}
+
+
+	void MeshBVH::build(const MeshInstance& mesh)
+	{
+		const auto& positions = mesh.getAttribute<glm::vec3>(vertexid::position);
+		mPositions = positions.getData();
+		mMesh = &mesh;
+		mIndexCount = countIndices(mesh);
+
+		// Gather the triangles of all shapes
+		std::vector<BuildTriangle> triangles;
+		TriangleIterator it(mesh);
+		while (!it.isDone())
+		{
+			const Triangle triangle = it.next();
+			const glm::uvec3 indices(triangle[0], triangle[1], triangle[2]);
+			triangles.push_back({ indices, (mPositions[indices.x] + mPositions[indices.y] + mPositions[indices.z]) / 3.0f });
+		}
+
+		mNodes.clear();
+		mNodes.reserve(triangles.empty() ? 0 : 2 * (triangles.size() / maxLeafSize) + 1);
+		mBounds = Bounds();
+		if (!triangles.empty())
+		{
+			buildNode(triangles, 0, static_cast<uint32>(triangles.size()));
+			mBounds = mNodes.front().mBounds;
+		}
+
+		// Leaves reference the triangles in build order
+		mTriangles.clear();
+		mTriangles.reserve(triangles.size());
+		for (const auto& triangle : triangles)
+			mTriangles.emplace_back(triangle.mIndices);
+	}
+
+
+	uint32 MeshBVH::buildNode(std::vector<BuildTriangle>& triangles, uint32 first, uint32 count)
+	{
+		const uint32 index = static_cast<uint32>(mNodes.size());
+		mNodes.emplace_back();
+
+		Bounds bounds, centroid_bounds;
+		for (uint32 i = first; i < first + count; i++)
+		{
+			const glm::uvec3& indices = triangles[i].mIndices;
+			bounds.extend(mPositions[indices.x]);
+			bounds.extend(mPositions[indices.y]);
+			bounds.extend(mPositions[indices.z]);
+			centroid_bounds.extend(triangles[i].mCentroid);
+		}
+		mNodes[index].mBounds = bounds;
+
+		// Split along the longest axis of the centroids, triangles with the same centroid can't be split
+		const glm::vec3 extent = centroid_bounds.mMax - centroid_bounds.mMin;
+		const int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+		if (count <= maxLeafSize || extent[axis] <= 0.0f)
+		{
+			mNodes[index].mFirst = first;
+			mNodes[index].mCount = count;
+			return index;
+		}
+
+		const uint32 middle = first + count / 2;
+		std::nth_element(triangles.begin() + first, triangles.begin() + middle, triangles.begin() + first + count,
+			[axis](const BuildTriangle& a, const BuildTriangle& b) { return a.mCentroid[axis] < b.mCentroid[axis]; });
+
+		buildNode(triangles, first, middle - first);
+		const uint32 right = buildNode(triangles, middle, first + count - middle);
+		mNodes[index].mRight = right;
+		return index;
+	}
+
+
+	bool MeshBVH::isCurrent(const MeshInstance& mesh) const
+	{
+		// Only the sizes are compared, the vertex data and indices are not read
+		return mMesh == &mesh && static_cast<size_t>(mesh.getNumVertices()) == mPositions.size() && countIndices(mesh) == mIndexCount;
+	}
+
+
+	bool MeshBVH::intersect(const glm::vec3& origin, const glm::vec3& direction, Hit& outHit, float maxDistance) const
+	{
+		if (mNodes.empty())
+			return false;
+
+		const glm::vec3 inv_direction = 1.0f / direction;
+		float closest = maxDistance;
+		bool found = false;
+
+		// Depth first, nearest child first: hits in the near child shorten the ray of the far child
+		std::array<uint32, maxDepth> stack;
+		int size = 0;
+		stack[size++] = 0;
+		while (size > 0)
+		{
+			const uint32 index = stack[--size];
+			const Node& node = mNodes[index];
+
+			if (node.mCount > 0)
+			{
+				for (uint32 i = node.mFirst; i < node.mFirst + node.mCount; i++)
+				{
+					const glm::uvec3& indices = mTriangles[i];
+					float distance; glm::vec2 uv;
+					if (intersectTriangle(origin, direction, mPositions[indices.x], mPositions[indices.y], mPositions[indices.z], distance, uv) && distance < closest)
+					{
+						closest = distance;
+						outHit.mDistance = distance;
+						outHit.mIndices = indices;
+						outHit.mBarycentric = { 1.0f - uv.x - uv.y, uv.x, uv.y };
+						found = true;
+					}
+				}
+				continue;
+			}
+
+			float left_distance, right_distance;
+			const uint32 left = index + 1;
+			const uint32 right = node.mRight;
+			const bool hit_left = mNodes[left].mBounds.intersect(origin, inv_direction, closest, left_distance);
+			const bool hit_right = mNodes[right].mBounds.intersect(origin, inv_direction, closest, right_distance);
+
+			// Push the far child first
+			if (hit_left && hit_right)
+			{
+				const bool left_first = left_distance <= right_distance;
+				stack[size++] = left_first ? right : left;
+				stack[size++] = left_first ? left : right;
+			}
+			else if (hit_left)
+			{
+				stack[size++] = left;
+			}
+			else if (hit_right)
+			{
+				stack[size++] = right;
+			}
+		}
+		return found;
+	}
+}
@@ -0,0 +1,122 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// External Includes
+#include <mesh.h>
+#include <nap/numeric.h>
+#include <glm/glm.hpp>
+#include <limits>
+#include <vector>
+
+namespace nap
+{
+	/**
+	 * Bounding volume hierarchy of the triangles of a mesh, used to find the closest intersection of a ray and a mesh
+	 * in logarithmic instead of linear time.
+	 *
+	 * The hierarchy is built in object space from a copy of the vertex positions. Rays must therefore be transformed into
+	 * object space, which only requires the ray and not every vertex to be transformed. A transformed direction doesn't have
+	 * to be normalized: the distance of a hit is expressed in the same ray parameter as the ray it was transformed from.
+	 *
+	 * Nodes are split at the median centroid along their longest axis, leaves hold up to 4 triangles.
+	 */
+	class NAPAPI MeshBVH final
+	{
+	public:
+		/**
+		 * Axis aligned bounding box
+		 */
+		struct Bounds
+		{
+			glm::vec3 mMin = glm::vec3(std::numeric_limits<float>::max());
+			glm::vec3 mMax = glm::vec3(std::numeric_limits<float>::lowest());
+
+			/**
+			 * Grows the bounds to include the point
+			 */
+			void extend(const glm::vec3& point)			{ mMin = glm::min(mMin, point); mMax = glm::max(mMax, point); }
+
+			/**
+			 * @return the bounds of the transformed corners
+			 */
+			Bounds transform(const glm::mat4& matrix) const;
+
+			/**
+			 * Intersects the bounds with a ray
+			 * @param origin ray origin
+			 * @param invDirection reciprocal of the ray direction
+			 * @param maxDistance the bounds are missed when entered beyond this distance
+			 * @param outDistance distance at which the ray enters the bounds, 0 when the origin is inside
+			 * @return if the ray intersects the bounds within the max distance
+			 */
+			bool intersect(const glm::vec3& origin, const glm::vec3& invDirection, float maxDistance, float& outDistance) const;
+		};
+
+		/**
+		 * Intersection of a ray and a triangle
+		 */
+		struct Hit
+		{
+			float		mDistance = 0.0f;					///< Ray parameter of the intersection
+			glm::uvec3	mIndices = { 0, 0, 0 };				///< Vertex indices of the triangle
+			glm::vec3	mBarycentric = { 1.0f, 0.0f, 0.0f };	///< Weight of every vertex of the triangle
+		};
+
+		/**
+		 * Builds the hierarchy from the triangles of the mesh
+		 * @param mesh the mesh to build the hierarchy for
+		 */
+		void build(const MeshInstance& mesh);
+
+		/**
+		 * The hierarchy is outdated when it was built for another mesh or the number of vertices or indices changed.
+		 * The vertex data isn't read, edits made in place that keep the number of vertices and indices are not detected:
+		 * build the hierarchy again after such an edit.
+		 * @return if the hierarchy was built for the mesh
+		 */
+		bool isCurrent(const MeshInstance& mesh) const;
+
+		/**
+		 * Finds the closest intersection of a ray and the mesh, in object space
+		 * @param origin ray origin
+		 * @param direction ray direction, doesn't have to be normalized
+		 * @param outHit the closest intersection
+		 * @param maxDistance intersections beyond this distance are ignored
+		 * @return if the ray intersects the mesh
+		 */
+		bool intersect(const glm::vec3& origin, const glm::vec3& direction, Hit& outHit, float maxDistance = std::numeric_limits<float>::max()) const;
+
+		/**
+		 * @return bounds of the mesh in object space
+		 */
+		const Bounds& getBounds() const									{ return mBounds; }
+
+	private:
+		struct Node
+		{
+			Bounds mBounds;
+			uint32 mFirst = 0;					///< First triangle of a leaf
+			uint32 mCount = 0;					///< Number of triangles of a leaf, 0 for an inner node
+			uint32 mRight = 0;					///< Right child of an inner node, the left child directly follows its parent
+		};
+
+		struct BuildTriangle
+		{
+			glm::uvec3 mIndices;
+			glm::vec3 mCentroid;
+		};
+
+		uint32 buildNode(std::vector<BuildTriangle>& triangles, uint32 first, uint32 count);
+
+		std::vector<Node>			mNodes;
+		std::vector<glm::uvec3>		mTriangles;
+		std::vector<glm::vec3>		mPositions;
+		Bounds						mBounds;
+
+		const MeshInstance*			mMesh = nullptr;			///< Mesh the hierarchy was built for
+		uint32						mIndexCount = 0;			///< Number of indices the hierarchy was built from
+	};
+}
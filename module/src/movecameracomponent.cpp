@@ -1,7 +1,9 @@
 #include "movecameracomponent.h"
+#include "lovepostersservice.h"
 
 // External Includes
 #include <entity.h>
+#include <nap/core.h>
 #include <glm/gtc/noise.hpp>
 #include <glm/gtc/random.hpp>
 #include <orthocameracomponent.h>
@@ -35,17 +37,34 @@ namespace nap
 
 	bool MoveCameraComponentInstance::init(utility::ErrorState& errorState)
 	{
+		mService = getEntityInstance()->getCore()->getService<LovePostersService>();
+
 		mResource = getComponent<MoveCameraComponent>();
 		mTransformComponent = &getEntityInstance()->getComponent<TransformComponentInstance>();
 		mCachedTransform = std::make_unique<AffineTransform>(*mTransformComponent);
 		mRandomSeed = { glm::linearRand<float>(0.0f, 1000.0f), glm::linearRand<float>(0.0f, 1000.0f), glm::linearRand<float>(0.0f, 1000.0f), glm::linearRand<float>(0.0f, 1000.0f) };
 
+		// Record the seed, or use the recorded seed when replaying
+		auto& recorder = mService->getControlRecorder();
+		recorder.eventReplayed.connect(mEventReplayedSlot);
+		recorder.record(ControlRecorder::EEventType::Seed, *this, "seed", { mRandomSeed.x, mRandomSeed.y, mRandomSeed.z, mRandomSeed.w });
+
 		return true;
 	}
 
 
+	void MoveCameraComponentInstance::onEventReplayed(const ControlRecorder::Event& event)
+	{
+		if (event.mType == ControlRecorder::EEventType::Seed && ControlRecorder::isSource(event, *this) && event.mValues.size() == 4)
+			mRandomSeed = { event.mValues[0], event.mValues[1], event.mValues[2], event.mValues[3] };
+	}
+
+
 	void MoveCameraComponentInstance::update(double deltaTime)
 	{
+		ProfileScope profile_scope(mService->getUpdateMarker(*this));
+		deltaTime = mService->getTimeStep(deltaTime);
+
 		if (!mResource->mEnable)
 			return;
 
@@ -4,9 +4,13 @@
 #include <parameternumeric.h>
 
 #include "affinetransform.h"
+#include "controlrecorder.h"
 
 namespace nap
 {
+	// Forward declares
+	class LovePostersService;
+
 	class MoveCameraComponentInstance;
 
 	/**
@@ -59,6 +63,7 @@ namespace nap
 		virtual void update(double deltaTime) override;
 
 		MoveCameraComponent* mResource = nullptr;
+		LovePostersService* mService = nullptr;		///< Provides the time step
 		TransformComponentInstance* mTransformComponent = nullptr;
 
 		std::unique_ptr<AffineTransform> mCachedTransform;
@@ -66,5 +71,10 @@ namespace nap
 
 		float mMovementTime = 0.0f;
 		glm::vec2 mTranslationAccumulator = { 0.0f, 0.0f };
+
+	private:
+		// Applies a replayed seed
+		void onEventReplayed(const ControlRecorder::Event& event);
+		Slot<const ControlRecorder::Event&> mEventReplayedSlot = { this, &MoveCameraComponentInstance::onEventReplayed };
 	};
 }
@@ -0,0 +1,56 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local includes
+#include "multivideoshader.h"
+#include "shaderutils.h"
+
+// External includes
+#include <nap/core.h>
+#include <renderservice.h>
+#include <renderadvancedservice.h>
+
+// nap::MultiVideoComputeShader run time class definition 
+RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::MultiVideoComputeShader)
+	RTTI_CONSTRUCTOR(nap::Core&)
+	RTTI_PROPERTY_FILELINK("ComputeShader",	&nap::MultiVideoComputeShader::mComputePath,	nap::rtti::EPropertyMetaData::Required, nap::rtti::EPropertyFileType::ComputeShader)
+	RTTI_PROPERTY("OutputTexture",			&nap::MultiVideoComputeShader::mOutputTexture,	nap::rtti::EPropertyMetaData::Required)
+RTTI_END_CLASS
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace nap
+{
+	MultiVideoComputeShader::MultiVideoComputeShader(Core& core) :
+		ComputeShader(core),
+		mRenderService(core.getService<RenderService>()),
+		mRenderAdvancedService(core.getService<RenderAdvancedService>())
+	{ }
+
+
+	bool MultiVideoComputeShader::init(utility::ErrorState& errorState)
+	{
+		if (!ComputeShader::init(errorState))
+			return false;
+
+		// One packed RGBA8 value per pixel
+		const uint64 pixels = static_cast<uint64>(mOutputTexture->mWidth) * mOutputTexture->mHeight;
+		const uint64 max_size = mRenderService->getPhysicalDeviceProperties().limits.maxStorageBufferRange;
+		if (!errorState.check(pixels > 0 && pixels * sizeof(uint) <= max_size, "%s: %llu pixels exceed the maximum storage buffer range of %llu bytes",
+			mID.c_str(), static_cast<unsigned long long>(pixels), static_cast<unsigned long long>(max_size)))
+			return false;
+
+		// Read compute shader file
+		std::string comp_source;
+		if (!errorState.check(utility::readFileToString(mComputePath, comp_source, errorState), "Unable to read shader file %s", mComputePath.c_str()))
+			return false;
+
+		if (!utility::insertShaderDefines(comp_source, mComputePath, utility::stringFormat("#define MAX_PIXELS %llu\n", static_cast<unsigned long long>(pixels)), errorState))
+			return false;
+
+		// Parse shader
+		std::string shader_name = utility::getFileNameWithoutExtension(mComputePath);
+		return load(shader_name, utility::getShaderSearchPaths(mComputePath, *mRenderService, *mRenderAdvancedService), comp_source.data(), comp_source.size(), errorState);
+	}
+}
@@ -0,0 +1,47 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// External Includes
+#include <computeshader.h>
+#include <rendertexture2d.h>
+#include <nap/resourceptr.h>
+
+namespace nap
+{
+	// Forward declares
+	class Core;
+	class RenderService;
+	class RenderAdvancedService;
+
+	/**
+	 * Compute shader that mixes the video layers of a nap::RenderMultiVideoComponent, see 'multivideo.comp'.
+	 *
+	 * NAP validates a buffer binding against the size of the array declared in the shader, storage buffers with
+	 * unsized arrays can't be bound. 'MAX_PIXELS' is therefore defined on load as the number of pixels of the
+	 * 'OutputTexture', which must be the output texture of the component.
+	 */
+	class NAPAPI MultiVideoComputeShader : public ComputeShader
+	{
+		RTTI_ENABLE(ComputeShader)
+	public:
+		// Constructor
+		MultiVideoComputeShader(Core& core);
+
+		/**
+		 * Loads the shader, defines 'MAX_PIXELS' and compiles it.
+		 * @param errorState contains the error if initialization fails.
+		 * @return if initialization succeeded.
+		 */
+		virtual bool init(utility::ErrorState& errorState) override;
+
+		std::string						mComputePath;				///< Property: 'ComputeShader' path to the compute shader on disk
+		ResourcePtr<RenderTexture2D>	mOutputTexture;				///< Property: 'OutputTexture' texture the video is mixed into, defines 'MAX_PIXELS'
+
+	private:
+		RenderService* mRenderService = nullptr;
+		RenderAdvancedService* mRenderAdvancedService = nullptr;
+	};
+}
@@ -0,0 +1,98 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "noisetexture.h"
+
+// External Includes
+#include <nap/core.h>
+#include <nap/logger.h>
+#include <nap/numeric.h>
+#include <mathutils.h>
+#include <glm/gtc/noise.hpp>
+#include <cmath>
+#include <vector>
+
+RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::NoiseTexture)
+	RTTI_CONSTRUCTOR(nap::Core&)
+	RTTI_PROPERTY("Resolution",		&nap::NoiseTexture::mResolution,	nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("Period",			&nap::NoiseTexture::mPeriod,		nap::rtti::EPropertyMetaData::Default)
+RTTI_END_CLASS
+
+
+namespace nap
+{
+	/**
+	 * Maps -1 to 1 to the full range of a 16 bit unsigned normalized value
+	 */
+	static uint16 encode(float value)
+	{
+		const float normalized = math::clamp<float>(value * 0.5f + 0.5f, 0.0f, 1.0f);
+		return static_cast<uint16>(std::lround(normalized * 65535.0f));
+	}
+
+
+	NoiseTexture::NoiseTexture(Core& core) :
+		Texture2D(core)
+	{ }
+
+
+	bool NoiseTexture::init(utility::ErrorState& errorState)
+	{
+		if (!errorState.check(mResolution >= 2, "%s: invalid resolution: %d", mID.c_str(), mResolution))
+			return false;
+
+		if (!errorState.check(mPeriod > 0, "%s: invalid period: %d", mID.c_str(), mPeriod))
+			return false;
+
+		// Periodic noise at the center of every voxel
+		const int res = mResolution;
+		const float step = static_cast<float>(mPeriod) / static_cast<float>(res);
+		const glm::vec3 period(static_cast<float>(mPeriod));
+		std::vector<float> values(static_cast<size_t>(res) * res * res);
+		for (int z = 0; z < res; z++)
+		{
+			for (int y = 0; y < res; y++)
+			{
+				for (int x = 0; x < res; x++)
+					values[(z * res + y) * res + x] = glm::perlin(glm::vec3(x, y, z) * step, period);
+			}
+		}
+
+		// Slices in a square grid, every slice has a wrapped border of 1 texel
+		const int slice_size = res + 2;
+		mColumns = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(res))));
+		const int rows = (res + mColumns - 1) / mColumns;
+		const int width = mColumns * slice_size;
+		const int height = rows * slice_size;
+
+		auto value = [&](int x, int y, int z)
+		{
+			return values[((z + res) % res * res + (y + res) % res) * res + (x + res) % res];
+		};
+
+		// Value only, the border texels wrap around
+		std::vector<uint16> texels(static_cast<size_t>(width) * height, 0);
+		for (int z = 0; z < res; z++)
+		{
+			const int origin_x = (z % mColumns) * slice_size;
+			const int origin_y = (z / mColumns) * slice_size;
+			for (int sy = 0; sy < slice_size; sy++)
+			{
+				uint16* row = texels.data() + static_cast<size_t>(origin_y + sy) * width + origin_x;
+				for (int sx = 0; sx < slice_size; sx++)
+					row[sx] = encode(value(sx - 1, sy - 1, z));
+			}
+		}
+
+		// Upload once
+		mUsage = Texture2D::EUsage::Static;
+		SurfaceDescriptor descriptor(width, height, ESurfaceDataType::USHORT, ESurfaceChannels::R, EColorSpace::Linear);
+		if (!Texture2D::init(descriptor, false, texels.data(), 0, errorState))
+			return false;
+
+		nap::Logger::info("%s: %d^3 noise, %dx%d atlas", mID.c_str(), res, width, height);
+		return true;
+	}
+}
@@ -0,0 +1,52 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// External Includes
+#include <texture.h>
+
+namespace nap
+{
+	// Forward Declares
+	class Core;
+
+	/**
+	 * Tileable 3D gradient noise, baked once on load. Sample it in place of the value of simplexd() of noise.glslinc,
+	 * one filtered fetch replaces a full gradient noise evaluation.
+	 *
+	 * NAP has no 3D textures, the volume is therefore stored as a 2D atlas of 'Resolution' slices of 'Resolution' x 'Resolution'
+	 * texels, laid out in rows of getColumns() slices. Every slice has a border of 1 texel that wraps around, bilinear filtering
+	 * never reads a neighbouring slice. The shader interpolates between the two nearest slices, see noisetexture.glslinc.
+	 *
+	 * The noise repeats every 'Period' units in all directions, which is the number of lattice cells along an axis of the volume.
+	 * Only the value is stored, as a single 16 bit unsigned normalized channel in the range -1 to 1. Sample along a direction
+	 * that isn't a rational multiple of an axis, for example time, to avoid repeating the noise, see noisetexture.glslinc.
+	 */
+	class NAPAPI NoiseTexture : public Texture2D
+	{
+		RTTI_ENABLE(Texture2D)
+	public:
+		// Constructor
+		NoiseTexture(Core& core);
+
+		/**
+		 * Bakes the noise and uploads the atlas
+		 * @param errorState contains the error if the texture can't be created
+		 * @return if the texture was created
+		 */
+		virtual bool init(utility::ErrorState& errorState) override;
+
+		/**
+		 * @return number of slices in a row of the atlas
+		 */
+		int getColumns() const					{ return mColumns; }
+
+		int mResolution = 64;					///< Property: 'Resolution' number of texels along an axis of the volume
+		int mPeriod = 8;						///< Property: 'Period' number of units after which the noise repeats
+
+	private:
+		int mColumns = 1;
+	};
+}
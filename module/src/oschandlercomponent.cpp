@@ -3,11 +3,13 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
 
 #include "oschandlercomponent.h"
+#include "lovepostersservice.h"
 
 // External includes
 #include <entity.h>
 #include <oscinputcomponent.h>
 #include <nap/logger.h>
+#include <nap/core.h>
 
 RTTI_BEGIN_CLASS(nap::OscHandlerComponent)
 	RTTI_PROPERTY("ParameterGroups",	&nap::OscHandlerComponent::mParameterGroups,	nap::rtti::EPropertyMetaData::Default)
@@ -34,6 +36,10 @@ namespace nap
 
         osc_input->messageReceived.connect(eventReceivedSlot);
 
+		// Replayed events are dispatched by the control recorder
+		mService = getEntityInstance()->getCore()->getService<LovePostersService>();
+		mService->getControlRecorder().eventReplayed.connect(eventReplayedSlot);
+
 		// Get the resource part of the component
 		mResource = getComponent<OscHandlerComponent>();
 
@@ -85,24 +91,43 @@ namespace nap
 	}
 
 
-	void OscHandlerComponentInstance::updateParameter(const OSCEvent& oscEvent, ParameterFloat& parameter)
+	void OscHandlerComponentInstance::updateParameter(const std::string& address, float value, ParameterFloat& parameter)
 	{
-		assert(oscEvent.getCount() >= 1);
-		float lvalue = math::lerp<float>(parameter.mMinimum, parameter.mMaximum, oscEvent[0].asFloat());
+		float lvalue = math::lerp<float>(parameter.mMinimum, parameter.mMaximum, value);
 		parameter.setValue(lvalue);
 
 		if (mResource->mVerbose)
-			nap::Logger::info("%s: %s = %.02f", mResource->mID.c_str(), oscEvent.getAddress().c_str(), lvalue);
+			nap::Logger::info("%s: %s = %.02f", mResource->mID.c_str(), address.c_str(), lvalue);
 	}
 
     
     void OscHandlerComponentInstance::onEventReceived(const OSCEvent& event)
     {
+		// Live input is ignored when replaying
+		auto& recorder = mService->getControlRecorder();
+		if (recorder.isReplaying() || event.getCount() < 1)
+			return;
+
+		float value = event[0].asFloat();
+		recorder.record(ControlRecorder::EEventType::Osc, *this, event.getAddress(), { value });
+		handleEvent(event.getAddress(), value);
+    }
+
+
+	void OscHandlerComponentInstance::onEventReplayed(const ControlRecorder::Event& event)
+	{
+		if (event.mType == ControlRecorder::EEventType::Osc && ControlRecorder::isSource(event, *this) && !event.mValues.empty())
+			handleEvent(event.mName, event.mValues[0]);
+	}
+
+
+	void OscHandlerComponentInstance::handleEvent(const std::string& address, float value)
+	{
 		// Find matching osc function
-		auto osc_func = mOscEventFunctions.find(event.getAddress());
+		auto osc_func = mOscEventFunctions.find(address);
 		if (osc_func != mOscEventFunctions.end())
-			(this->*(osc_func->second.mFunction))(event, *(osc_func->second.mParameter));
-    }
+			(this->*(osc_func->second.mFunction))(address, value, *(osc_func->second.mParameter));
+	}
 
 
 	bool OscHandlerComponentInstance::getParameterAddress(ParameterFloat* parameter, std::string& address) const
@@ -12,10 +12,14 @@
 #include <parameternumeric.h>
 #include <parametergroup.h>
 
+// Local includes
+#include "controlrecorder.h"
+
 namespace nap
 {
     // Forward Declare
     class OscHandlerComponentInstance;
+    class LovePostersService;
    
 	/**
 	 * Component that converts incoming osc messages into a string and stores them for display later on.
@@ -73,8 +77,22 @@ namespace nap
 		 */
         Slot<const OSCEvent&> eventReceivedSlot = { this, &OscHandlerComponentInstance::onEventReceived };
 
+		/**
+		 * Called when the control recorder replays an event, live osc events are ignored during replay
+		 * @param event the replayed event
+		 */
+		void onEventReplayed(const ControlRecorder::Event& event);
+
+		/**
+		 * Slot that is connected to the control recorder
+		 */
+		Slot<const ControlRecorder::Event&> eventReplayedSlot = { this, &OscHandlerComponentInstance::onEventReplayed };
+
+		// Dispatches a value received on the given address
+		void handleEvent(const std::string& address, float value);
+
 		// This map holds all the various callbacks based on id
-		typedef void (OscHandlerComponentInstance::*OscEventFunc)(const OSCEvent&, ParameterFloat&);
+		typedef void (OscHandlerComponentInstance::*OscEventFunc)(const std::string&, float, ParameterFloat&);
 
 		// Simple struct that binds a function to a parameter
 		struct OSCFunctionMapping
@@ -91,11 +109,12 @@ namespace nap
 		void addParameter(std::string oscAddress, ParameterFloat& parameter);
 
 		// Generic parameter update function
-		void updateParameter(const OSCEvent& oscEvent, ParameterFloat& parameter);
+		void updateParameter(const std::string& address, float value, ParameterFloat& parameter);
 
 		// Cached list of addresses for display in the OSC menu
 		std::vector<std::string> mCachedAddresses;
 
 		OscHandlerComponent* mResource = nullptr;
+		LovePostersService* mService = nullptr;
 	};
 }
@@ -0,0 +1,59 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "packedfillpolicy.h"
+
+// External Includes
+#include <mathutils.h>
+#include <glm/gtc/packing.hpp>
+
+RTTI_BEGIN_CLASS(nap::PackedHalfFillPolicy)
+	RTTI_PROPERTY("LowerBound",		&nap::PackedHalfFillPolicy::mLowerBound,	nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("UpperBound",		&nap::PackedHalfFillPolicy::mUpperBound,	nap::rtti::EPropertyMetaData::Default)
+RTTI_END_CLASS
+
+RTTI_BEGIN_CLASS(nap::PackedUnormFillPolicy)
+RTTI_END_CLASS
+
+
+namespace nap
+{
+	bool PackedHalfFillPolicy::fill(uint numElements, uint* data, utility::ErrorState& errorState)
+	{
+		if (!errorState.check(numElements % 2 == 0, "%s: %d elements can't hold packed half vectors, count must be even", mID.c_str(), numElements))
+			return false;
+
+		for (uint i = 0; i < numElements; i += 2)
+		{
+			const glm::vec4 value =
+			{
+				math::random<float>(mLowerBound.x, mUpperBound.x),
+				math::random<float>(mLowerBound.y, mUpperBound.y),
+				math::random<float>(mLowerBound.z, mUpperBound.z),
+				math::random<float>(mLowerBound.w, mUpperBound.w)
+			};
+			data[i]		= glm::packHalf2x16({ value.x, value.y });
+			data[i + 1]	= glm::packHalf2x16({ value.z, value.w });
+		}
+		return true;
+	}
+
+
+	bool PackedUnormFillPolicy::fill(uint numElements, uint* data, utility::ErrorState& errorState)
+	{
+		for (uint i = 0; i < numElements; i++)
+		{
+			const glm::vec4 value =
+			{
+				math::random<float>(0.0f, 1.0f),
+				math::random<float>(0.0f, 1.0f),
+				math::random<float>(0.0f, 1.0f),
+				math::random<float>(0.0f, 1.0f)
+			};
+			data[i] = glm::packUnorm4x8(value);
+		}
+		return true;
+	}
+}
@@ -0,0 +1,53 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// External Includes
+#include <fillpolicy.h>
+#include <glm/glm.hpp>
+
+namespace nap
+{
+	/**
+	 * Fills a nap::GPUBufferUInt with random vectors packed as four half floats, two elements per vector.
+	 * Unpack in the shader with unpackHalf2x16(). The buffer count must therefore be twice the number of vectors.
+	 * Every component is uniformly distributed between the lower and upper bound.
+	 */
+	class NAPAPI PackedHalfFillPolicy : public FillPolicyUInt
+	{
+		RTTI_ENABLE(FillPolicyUInt)
+	public:
+		/**
+		 * Fills the buffer with random packed vectors
+		 * @param numElements number of elements, two per vector
+		 * @param data the data to fill
+		 * @param errorState contains the error if the buffer can't be filled
+		 * @return if the buffer was filled
+		 */
+		virtual bool fill(uint numElements, uint* data, utility::ErrorState& errorState) override;
+
+		glm::vec4 mLowerBound = { 0.0f, 0.0f, 0.0f, 0.0f };		///< Property: 'LowerBound' lower bound of every component
+		glm::vec4 mUpperBound = { 1.0f, 1.0f, 1.0f, 1.0f };		///< Property: 'UpperBound' upper bound of every component
+	};
+
+
+	/**
+	 * Fills a nap::GPUBufferUInt with random vectors packed as RGBA8 unsigned normalized values, one element per vector.
+	 * Unpack in the shader with unpackUnorm4x8(). Every component is uniformly distributed between 0 and 1.
+	 */
+	class NAPAPI PackedUnormFillPolicy : public FillPolicyUInt
+	{
+		RTTI_ENABLE(FillPolicyUInt)
+	public:
+		/**
+		 * Fills the buffer with random packed vectors
+		 * @param numElements number of elements, one per vector
+		 * @param data the data to fill
+		 * @param errorState contains the error if the buffer can't be filled
+		 * @return if the buffer was filled
+		 */
+		virtual bool fill(uint numElements, uint* data, utility::ErrorState& errorState) override;
+	};
+}
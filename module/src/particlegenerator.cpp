@@ -0,0 +1,172 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "particlegenerator.h"
+#include "lovepostersservice.h"
+#include "spriteshader.h"
+
+// External Includes
+#include <nap/core.h>
+#include <renderservice.h>
+
+RTTI_BEGIN_ENUM(nap::EParticleDistribution)
+	RTTI_ENUM_VALUE(nap::EParticleDistribution::Box,		"Box"),
+	RTTI_ENUM_VALUE(nap::EParticleDistribution::Sphere,		"Sphere"),
+	RTTI_ENUM_VALUE(nap::EParticleDistribution::Shell,		"Shell")
+RTTI_END_ENUM
+
+RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::ParticleGenerator)
+	RTTI_CONSTRUCTOR(nap::Core&)
+	RTTI_PROPERTY("Mesh",						&nap::ParticleGenerator::mMesh,								nap::rtti::EPropertyMetaData::Required)
+	RTTI_PROPERTY("ComputeMaterialInstance",	&nap::ParticleGenerator::mComputeMaterialInstanceResource,	nap::rtti::EPropertyMetaData::Required)
+	RTTI_PROPERTY("Distribution",				&nap::ParticleGenerator::mDistribution,						nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("LowerBound",					&nap::ParticleGenerator::mLowerBound,						nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("UpperBound",					&nap::ParticleGenerator::mUpperBound,						nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("InnerRadius",				&nap::ParticleGenerator::mInnerRadius,						nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("Seed",						&nap::ParticleGenerator::mSeed,								nap::rtti::EPropertyMetaData::Default)
+RTTI_END_CLASS
+
+namespace nap
+{
+	static constexpr const char* positionBufferName = "PositionBuffer_Out";
+	static constexpr const char* hashBufferName = "HashBuffer_Out";
+
+
+	/**
+	 * Creates a device local buffer of 'count' elements, the contents are written on the GPU
+	 */
+	template<typename BufferType>
+	static std::unique_ptr<BufferType> createBuffer(Core& core, const std::string& id, uint count, utility::ErrorState& errorState)
+	{
+		auto buffer = std::make_unique<BufferType>(core);
+		buffer->mID = id;
+		buffer->mUsage = EMemoryUsage::DeviceLocal;
+		buffer->mCount = count;
+		if (!buffer->init(errorState))
+			return nullptr;
+		return buffer;
+	}
+
+
+	/**
+	 * Binds the buffer to the material, fails if the material has no buffer of this type
+	 */
+	template<typename BindingType, typename BufferType>
+	static bool bindBuffer(ComputeMaterialInstance& material, const std::string& name, BufferType& buffer, const std::string& id, utility::ErrorState& errorState)
+	{
+		auto* binding = material.getOrCreateBuffer<BindingType>(name);
+		if (!errorState.check(binding != nullptr, "%s: material has no buffer '%s' of type %s", id.c_str(), name.c_str(), RTTI_OF(BindingType).get_name().data()))
+			return false;
+
+		binding->setBuffer(buffer);
+		return true;
+	}
+
+
+	ParticleGenerator::ParticleGenerator(Core& core) :
+		mCore(core),
+		mRenderService(core.getService<RenderService>()),
+		mPipelineCache(&core.getService<LovePostersService>()->getPipelineCache())
+	{ }
+
+
+	ParticleGenerator::~ParticleGenerator()
+	{
+		PipelineCache::destroyPipeline(*mRenderService, mComputePipeline);
+	}
+
+
+	bool ParticleGenerator::init(utility::ErrorState& errorState)
+	{
+		if (!mComputeMaterialInstance.init(*mRenderService, mComputeMaterialInstanceResource, errorState))
+			return false;
+
+		if (!mPipelineCache->createComputePipeline(mComputeMaterialInstance.getComputeMaterial().getShader(), mComputePipeline, errorState))
+			return false;
+
+		// The array sizes of the shader are defined by its mesh
+		const auto* sprite_shader = rtti_cast<const SpriteComputeShader>(&mComputeMaterialInstance.getComputeMaterial().getShader());
+		if (!errorState.check(sprite_shader == nullptr || sprite_shader->mMesh == mMesh, "%s: compute shader is not compiled for mesh '%s'", mID.c_str(), mMesh->mID.c_str()))
+			return false;
+
+		// Create the buffers in the format the shader declares, packed positions take two elements per particle
+		const uint count = mMesh->getCount();
+		if (mComputeMaterialInstance.getOrCreateBuffer<BufferBindingUIntInstance>(positionBufferName) != nullptr)
+		{
+			mPackedPositionBuffer = createBuffer<GPUBufferUInt>(mCore, utility::stringFormat("%s_%s", mID.c_str(), positionBufferName), count * 2, errorState);
+			mPackedHashBuffer = createBuffer<GPUBufferUInt>(mCore, utility::stringFormat("%s_%s", mID.c_str(), hashBufferName), count, errorState);
+			if (mPackedPositionBuffer == nullptr || mPackedHashBuffer == nullptr)
+				return false;
+		}
+		else
+		{
+			mPositionBuffer = createBuffer<GPUBufferVec4>(mCore, utility::stringFormat("%s_%s", mID.c_str(), positionBufferName), count, errorState);
+			mHashBuffer = createBuffer<GPUBufferVec4>(mCore, utility::stringFormat("%s_%s", mID.c_str(), hashBufferName), count, errorState);
+			if (mPositionBuffer == nullptr || mHashBuffer == nullptr)
+				return false;
+		}
+
+		if (!bindBuffers(mComputeMaterialInstance, positionBufferName, hashBufferName, errorState))
+			return false;
+
+		if (!errorState.check(mInnerRadius >= 0.0f && mInnerRadius <= 1.0f, "%s: inner radius must be in the range 0-1", mID.c_str()))
+			return false;
+
+		// Parameters are constant, set them once
+		auto* ubo = mComputeMaterialInstance.getOrCreateUniform("UBO");
+		if (!errorState.check(ubo != nullptr, "%s: compute material has no uniform struct 'UBO'", mID.c_str()))
+			return false;
+
+		ubo->getOrCreateUniform<UniformVec4Instance>("lowerBound")->setValue(mLowerBound);
+		ubo->getOrCreateUniform<UniformVec4Instance>("upperBound")->setValue(mUpperBound);
+		ubo->getOrCreateUniform<UniformFloatInstance>("innerRadius")->setValue(mInnerRadius);
+		ubo->getOrCreateUniform<UniformUIntInstance>("seed")->setValue(mSeed);
+		ubo->getOrCreateUniform<UniformUIntInstance>("distribution")->setValue(static_cast<uint>(mDistribution));
+
+		return true;
+	}
+
+
+	bool ParticleGenerator::bindBuffers(ComputeMaterialInstance& material, const std::string& positionName, const std::string& hashName, utility::ErrorState& errorState)
+	{
+		if (mPackedPositionBuffer != nullptr)
+		{
+			return bindBuffer<BufferBindingUIntInstance>(material, positionName, *mPackedPositionBuffer, mID, errorState) &&
+				bindBuffer<BufferBindingUIntInstance>(material, hashName, *mPackedHashBuffer, mID, errorState);
+		}
+
+		return bindBuffer<BufferBindingVec4Instance>(material, positionName, *mPositionBuffer, mID, errorState) &&
+			bindBuffer<BufferBindingVec4Instance>(material, hashName, *mHashBuffer, mID, errorState);
+	}
+
+
+	void ParticleGenerator::generate()
+	{
+		if (mGenerated)
+			return;
+
+		// Get current command buffer, should be compute.
+		auto command_buffer = mRenderService->getCurrentCommandBuffer();
+
+		// Get valid descriptor set and pipeline
+		const DescriptorSet& descriptor_set = mComputeMaterialInstance.update();
+		vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, mComputePipeline.mPipeline);
+		vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, mComputePipeline.mLayout, 0, 1, &descriptor_set.mSet, 0, nullptr);
+
+		// One invocation per particle
+		const uint group_size = mComputeMaterialInstance.getWorkGroupSize().x;
+		vkCmdDispatch(command_buffer, (mMesh->getCount() + group_size - 1) / group_size, 1, 1);
+
+		// Make the particles visible to the compute and render passes that read them
+		VkMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+			0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+		mGenerated = true;
+	}
+}
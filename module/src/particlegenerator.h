@@ -0,0 +1,105 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// Local Includes
+#include "particlemesh.h"
+
+// External Includes
+#include <nap/resource.h>
+#include <computematerialinstance.h>
+#include <uniforminstance.h>
+#include <renderservice.h>
+#include <gpubuffer.h>
+#include <glm/glm.hpp>
+
+namespace nap
+{
+	// Forward Declares
+	class Core;
+	class PipelineCache;
+
+	/**
+	 * Shape of the volume the particles are distributed in
+	 */
+	enum class EParticleDistribution : int
+	{
+		Box		= 0,		///< Uniformly distributed in a box
+		Sphere	= 1,		///< Uniformly distributed in an ellipsoid
+		Shell	= 2			///< Uniformly distributed in between the 'InnerRadius' and the surface of an ellipsoid
+	};
+
+
+	/**
+	 * Generates the particle position and hash buffers on the GPU, in place of a fill policy that runs on the CPU.
+	 * The buffers don't need a fill policy or staging upload, startup time and memory don't depend on the particle count.
+	 *
+	 * The buffers are created on init, sized for the count of the 'Mesh'. They are nap::GPUBufferVec4 or packed
+	 * nap::GPUBufferUInt buffers, matching the type the compute shader declares, see nap::SpriteComputeShader.
+	 * The 'ComputeMaterialInstance' writes them as 'PositionBuffer_Out' and 'HashBuffer_Out', one invocation
+	 * per particle. Use bindBuffers() to read them in another material. The particles are distributed in the box between 'LowerBound' and 'UpperBound', or in the ellipsoid
+	 * that fits in it. The size (w) is uniformly distributed between the w component of both bounds.
+	 * The same 'Seed' always generates the same particles.
+	 *
+	 * The buffers are generated once, on the first call to generate().
+	 */
+	class NAPAPI ParticleGenerator : public Resource
+	{
+		RTTI_ENABLE(Resource)
+	public:
+		// Constructor
+		ParticleGenerator(Core& core);
+		virtual ~ParticleGenerator() override;
+
+		/**
+		 * Initializes the compute material
+		 * @param errorState contains the error if initialization fails
+		 * @return if initialization succeeded
+		 */
+		virtual bool init(utility::ErrorState& errorState) override;
+
+		/**
+		 * Generates the particles, nothing is dispatched when the particles are already generated.
+		 * Call this in your application render() call, in between nap::RenderService::beginComputeRecording() and
+		 * nap::RenderService::endComputeRecording(), before the buffers are read.
+		 */
+		void generate();
+
+		/**
+		 * Binds the particle buffers to a material that reads them.
+		 * @param material the material to bind the buffers to
+		 * @param positionName name of the position buffer in the material
+		 * @param hashName name of the hash buffer in the material
+		 * @param errorState contains the error if the material has no buffers of the same type
+		 * @return if the buffers are bound
+		 */
+		bool bindBuffers(ComputeMaterialInstance& material, const std::string& positionName, const std::string& hashName, utility::ErrorState& errorState);
+
+		/**
+		 * @return if the particles are generated
+		 */
+		bool isGenerated() const								{ return mGenerated; }
+
+		ResourcePtr<ParticleMesh> mMesh;											///< Property: 'Mesh' the particles to generate, determines the size of the buffers
+		ComputeMaterialInstanceResource mComputeMaterialInstanceResource;			///< Property: 'ComputeMaterialInstance' writes the particle buffers
+		EParticleDistribution mDistribution = EParticleDistribution::Box;			///< Property: 'Distribution' shape of the volume
+		glm::vec4 mLowerBound = { -1.0f, -1.0f, -1.0f, 0.0f };						///< Property: 'LowerBound' lower bound of the position (xyz) and size (w)
+		glm::vec4 mUpperBound = { 1.0f, 1.0f, 1.0f, 1.0f };							///< Property: 'UpperBound' upper bound of the position (xyz) and size (w)
+		float mInnerRadius = 0.5f;													///< Property: 'InnerRadius' inner radius of the shell relative to the outer radius, 0-1
+		uint mSeed = 0;																///< Property: 'Seed' the particles of the same seed are identical
+
+	private:
+		Core& mCore;
+		RenderService* mRenderService = nullptr;
+		ComputeMaterialInstance mComputeMaterialInstance;
+		RenderService::Pipeline mComputePipeline;									///< Created from the persistent pipeline cache
+		PipelineCache* mPipelineCache = nullptr;
+		std::unique_ptr<GPUBufferVec4> mPositionBuffer;								///< Positions and sizes, one element per particle
+		std::unique_ptr<GPUBufferVec4> mHashBuffer;									///< Hashes, one element per particle
+		std::unique_ptr<GPUBufferUInt> mPackedPositionBuffer;						///< Positions and sizes as half floats, two elements per particle
+		std::unique_ptr<GPUBufferUInt> mPackedHashBuffer;							///< Hashes as RGBA8 unorm, one element per particle
+		bool mGenerated = false;
+	};
+}
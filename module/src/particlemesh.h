@@ -25,7 +25,7 @@ namespace nap
 		EMemoryUsage	mUsage = EMemoryUsage::Static;				///< Property: 'Usage' If the plane is uploaded once or frequently updated.
 		ECullMode		mCullMode = ECullMode::None;				///< Property: 'CullMode' Plane cull mode, defaults to no culling
 		EPolygonMode	mPolygonMode = EPolygonMode::Fill;			///< Property: 'PolygonMode' Polygon rasterization mode (fill, line, points)
-		uint			mCount = 32;
+		uint			mCount = 32;								///< Property: 'Count' number of particles, the bound particle buffers must hold exactly this many elements
 
 	private:
 		std::unique_ptr<MeshInstance>	mMeshInstance = nullptr;	///< The mesh instance to construct
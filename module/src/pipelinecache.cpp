@@ -0,0 +1,145 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "pipelinecache.h"
+
+// External Includes
+#include <nap/logger.h>
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+#include <vector>
+
+namespace nap
+{
+	/**
+	 * Verifies that the cache data was written by the same device and driver, see VkPipelineCacheHeaderVersionOne
+	 */
+	static bool isCompatible(const std::vector<char>& data, const VkPhysicalDeviceProperties& properties)
+	{
+		const size_t header_size = 4 * sizeof(uint32) + VK_UUID_SIZE;
+		if (data.size() < header_size)
+			return false;
+
+		uint32 header[4];
+		std::memcpy(header, data.data(), sizeof(header));
+		return header[0] >= header_size && header[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+			header[2] == properties.vendorID && header[3] == properties.deviceID &&
+			std::memcmp(data.data() + sizeof(header), properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+	}
+
+
+	PipelineCache::PipelineCache(RenderService& renderService) :
+		mRenderService(renderService)
+	{ }
+
+
+	PipelineCache::~PipelineCache()
+	{
+		shutdown();
+	}
+
+
+	bool PipelineCache::init(const std::string& path, utility::ErrorState& errorState)
+	{
+		mPath = path;
+
+		// Load the previous run, ignored when written by a different device or driver
+		std::vector<char> data;
+		{
+			std::ifstream file(path, std::ios::in | std::ios::binary);
+			data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		}
+
+		if (!data.empty() && !isCompatible(data, mRenderService.getPhysicalDeviceProperties()))
+		{
+			nap::Logger::info("Pipeline cache %s was written by a different device or driver, ignored", path.c_str());
+			data.clear();
+		}
+
+		VkPipelineCacheCreateInfo cache_info = {};
+		cache_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+		cache_info.initialDataSize = data.size();
+		cache_info.pInitialData = data.empty() ? nullptr : data.data();
+		if (!errorState.check(vkCreatePipelineCache(mRenderService.getDevice(), &cache_info, nullptr, &mCache) == VK_SUCCESS, "Unable to create pipeline cache"))
+			return false;
+
+		nap::Logger::info("Pipeline cache: %s (%d bytes loaded)", path.c_str(), static_cast<int>(data.size()));
+		return true;
+	}
+
+
+	void PipelineCache::shutdown()
+	{
+		if (mCache == VK_NULL_HANDLE)
+			return;
+
+		// Write all pipelines created in this and previous runs
+		size_t size = 0;
+		std::vector<char> data;
+		if (vkGetPipelineCacheData(mRenderService.getDevice(), mCache, &size, nullptr) == VK_SUCCESS && size > 0)
+		{
+			data.resize(size);
+			if (vkGetPipelineCacheData(mRenderService.getDevice(), mCache, &size, data.data()) != VK_SUCCESS)
+				size = 0;
+		}
+
+		if (size > 0)
+		{
+			std::error_code error;
+			std::filesystem::create_directories(std::filesystem::path(mPath).parent_path(), error);
+			std::ofstream file(mPath, std::ios::out | std::ios::binary | std::ios::trunc);
+			file.write(data.data(), size);
+			if (!file.good())
+				nap::Logger::warn("Unable to write pipeline cache: %s", mPath.c_str());
+		}
+
+		vkDestroyPipelineCache(mRenderService.getDevice(), mCache, nullptr);
+		mCache = VK_NULL_HANDLE;
+	}
+
+
+	bool PipelineCache::createComputePipeline(const ComputeShader& shader, RenderService::Pipeline& outPipeline, utility::ErrorState& errorState)
+	{
+		VkDevice device = mRenderService.getDevice();
+		VkDescriptorSetLayout set_layout = shader.getDescriptorSetLayout();
+
+		VkPipelineLayoutCreateInfo layout_info = {};
+		layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		layout_info.setLayoutCount = 1;
+		layout_info.pSetLayouts = &set_layout;
+		if (!errorState.check(vkCreatePipelineLayout(device, &layout_info, nullptr, &outPipeline.mLayout) == VK_SUCCESS, "%s: unable to create pipeline layout", shader.mID.c_str()))
+			return false;
+
+		VkComputePipelineCreateInfo pipeline_info = {};
+		pipeline_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipeline_info.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		pipeline_info.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		pipeline_info.stage.module = shader.getComputeModule();
+		pipeline_info.stage.pName = "main";
+		pipeline_info.layout = outPipeline.mLayout;
+		if (!errorState.check(vkCreateComputePipelines(device, mCache, 1, &pipeline_info, nullptr, &outPipeline.mPipeline) == VK_SUCCESS, "%s: unable to create compute pipeline", shader.mID.c_str()))
+		{
+			vkDestroyPipelineLayout(device, outPipeline.mLayout, nullptr);
+			outPipeline = { };
+			return false;
+		}
+		return true;
+	}
+
+
+	void PipelineCache::destroyPipeline(RenderService& renderService, RenderService::Pipeline& pipeline)
+	{
+		if (pipeline.mPipeline == VK_NULL_HANDLE && pipeline.mLayout == VK_NULL_HANDLE)
+			return;
+
+		renderService.queueVulkanObjectDestructor([pipeline](RenderService& service)
+		{
+			vkDestroyPipeline(service.getDevice(), pipeline.mPipeline, nullptr);
+			vkDestroyPipelineLayout(service.getDevice(), pipeline.mLayout, nullptr);
+		});
+		pipeline = { };
+	}
+}
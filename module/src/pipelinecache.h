@@ -0,0 +1,68 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// External Includes
+#include <utility/errorstate.h>
+#include <renderservice.h>
+#include <computeshader.h>
+#include <string>
+
+namespace nap
+{
+	/**
+	 * Persistent Vulkan pipeline cache for the compute pipelines of this module.
+	 *
+	 * The nap::RenderService creates its pipelines without a VkPipelineCache, compute pipelines of this module are therefore
+	 * created here instead. The cache is loaded from disk on init() and written back on shutdown(), pipelines that were
+	 * created in a previous run are retrieved from the cache instead of compiled. The driver keys every entry on the SPIR-V
+	 * of the shader, which includes the defines the shader was compiled with. A file written by a different device or
+	 * driver is ignored.
+	 *
+	 * The pipeline layout only holds the descriptor set layout of the shader, descriptor sets of the material are compatible.
+	 * Work group sizes must be declared in the shader, specialization constants are not applied.
+	 */
+	class NAPAPI PipelineCache final
+	{
+	public:
+		PipelineCache(RenderService& renderService);
+		~PipelineCache();
+
+		/**
+		 * Creates the cache, initialized with the contents of the file when it exists and is compatible with the device
+		 * @param path the cache file
+		 * @param errorState contains the error if the cache can't be created
+		 * @return if the cache is created
+		 */
+		bool init(const std::string& path, utility::ErrorState& errorState);
+
+		/**
+		 * Writes the cache to disk and destroys it
+		 */
+		void shutdown();
+
+		/**
+		 * Creates a compute pipeline for the shader using the cache.
+		 * The pipeline is owned by the caller, release it using destroyPipeline().
+		 * @param shader the compute shader
+		 * @param outPipeline the pipeline and its layout
+		 * @param errorState contains the error if the pipeline can't be created
+		 * @return if the pipeline is created
+		 */
+		bool createComputePipeline(const ComputeShader& shader, RenderService::Pipeline& outPipeline, utility::ErrorState& errorState);
+
+		/**
+		 * Destroys the pipeline and its layout when the frames in flight that might use it are completed
+		 * @param renderService the render service the pipeline was created with
+		 * @param pipeline the pipeline to destroy, reset to a null handle
+		 */
+		static void destroyPipeline(RenderService& renderService, RenderService::Pipeline& pipeline);
+
+	private:
+		RenderService&		mRenderService;
+		VkPipelineCache		mCache = VK_NULL_HANDLE;
+		std::string			mPath;
+	};
+}
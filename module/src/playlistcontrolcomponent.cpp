@@ -1,10 +1,12 @@
 #include "playlistcontrolcomponent.h"
+#include "lovepostersservice.h"
 
 // Nap includes
 #include <entity.h>
 #include <nap/core.h>
 #include <mathutils.h>
 #include <nap/logger.h>
+#include <algorithm>
 
 // RTTI
 
@@ -87,6 +89,8 @@ namespace nap
 
 	bool PlaylistControlComponentInstance::init(utility::ErrorState& errorState)
 	{
+		mService = getEntityInstance()->getCore()->getService<LovePostersService>();
+
         // Utility function to get root entity
         static auto find_root_entity =[](EntityInstance* entity)->EntityInstance*
         {
@@ -183,6 +187,9 @@ namespace nap
 			mPermutedPlaylist.emplace_back(&preset);
 		permute(mPermutedPlaylist);
 
+        // Playlist switches are replaced by recorded switches on replay
+        mService->getControlRecorder().eventReplayed.connect(mEventReplayedSlot);
+
         mRandomizePlaylist = mResource->mRandomizePlaylist;
         mVerbose = mResource->mVerbose;
 
@@ -207,15 +214,31 @@ namespace nap
 
 	void PlaylistControlComponentInstance::update(double deltaTime)
 	{
+		ProfileScope profile_scope(mService->getUpdateMarker(*this));
+		deltaTime = mService->getTimeStep(deltaTime);
+
 		if (!isEnabled() || mPlaylist.empty())
 			return;
 
 		mCurrentPlaylistItemElapsedTime += deltaTime;
-		if (mCurrentPlaylistItemElapsedTime >= mCurrentPlaylistItemDuration)
+		if (mCurrentPlaylistItemElapsedTime >= mCurrentPlaylistItemDuration && !mService->getControlRecorder().isReplaying())
             nextItem();
 	}
 
 
+	float PlaylistControlComponentInstance::getTimeUntilNextItem() const
+	{
+		if (!isEnabled() || mPlaylist.empty())
+			return -1.0f;
+
+		// While replaying the next switch is the next recorded one
+		if (mService->getControlRecorder().isReplaying())
+			return mReplayItemDuration < 0.0f ? -1.0f : std::max(mReplayItemDuration - mCurrentPlaylistItemElapsedTime, 0.0f);
+
+		return std::max(mCurrentPlaylistItemDuration - mCurrentPlaylistItemElapsedTime, 0.0f);
+	}
+
+
 	void PlaylistControlComponentInstance::nextItem()
 	{
 		mCurrentPlaylistIndex++;
@@ -245,17 +268,25 @@ namespace nap
     {
         assert(index >= 0 && index < mPlaylist.size());
 
-        mCurrentPlaylistIndex = index;
-
-        auto item = &mPlaylist[mCurrentPlaylistIndex];
+        auto item = &mPlaylist[index];
         if (randomize)
-            item = mPermutedPlaylist[mCurrentPlaylistIndex];
+            item = mPermutedPlaylist[index];
 
-        mCurrentPlaylistItemDuration = item->mAverageDuration + math::random(-item->mDurationDeviation / 2.f, item->mDurationDeviation / 2.f);
+        float duration = item->mAverageDuration + math::random(-item->mDurationDeviation / 2.f, item->mDurationDeviation / 2.f);
+        float item_index = static_cast<float>(item - mPlaylist.data());
+        mService->getControlRecorder().record(ControlRecorder::EEventType::Playlist, *this, "item", { static_cast<float>(index), item_index, duration });
+        applyItem(index, *item, duration);
+    }
+
+
+    void PlaylistControlComponentInstance::applyItem(int index, Item& item, float duration)
+    {
+        mCurrentPlaylistIndex = index;
+        mCurrentPlaylistItemDuration = duration;
         mCurrentPlaylistItemElapsedTime = 0;
-        mCurrentPlaylistItem = item;
+        mCurrentPlaylistItem = &item;
 
-        for(auto& group : item->mGroups)
+        for(auto& group : item.mGroups)
         {
             auto* blender = group.mBlender;
             blender->getComponent<ParameterBlendComponent>()->mPresetIndex->setValue(group.mPresetIndex);
@@ -264,8 +295,28 @@ namespace nap
 
         if(mVerbose)
         {
-            nap::Logger::info(*this, "Switching to playlist item %s", item->mID.c_str());
+            nap::Logger::info(*this, "Switching to playlist item %s", item.mID.c_str());
+        }
+    }
+
+
+    void PlaylistControlComponentInstance::onEventReplayed(const ControlRecorder::Event& event)
+    {
+        if (event.mType != ControlRecorder::EEventType::Playlist || !ControlRecorder::isSource(event, *this) || event.mValues.size() < 3)
+            return;
+
+        int index = static_cast<int>(event.mValues[0]);
+        int item_index = static_cast<int>(event.mValues[1]);
+        if (index < 0 || index >= mPlaylist.size() || item_index < 0 || item_index >= mPlaylist.size())
+        {
+            nap::Logger::warn(*this, "Invalid replayed playlist item %i", item_index);
+            return;
         }
+        applyItem(index, mPlaylist[item_index], event.mValues[2]);
+
+        // The recorded switch can differ from the drawn duration by a frame, use the recorded time of the next switch
+        const auto* next = mService->getControlRecorder().findNextEvent(ControlRecorder::EEventType::Playlist, *this, event.mName);
+        mReplayItemDuration = next != nullptr ? next->mTime - event.mTime : -1.0f;
     }
 
 
@@ -1,5 +1,8 @@
 #pragma once
 
+// Local Includes
+#include "controlrecorder.h"
+
 // Nap includes
 #include <component.h>
 #include <parameter.h>
@@ -9,6 +12,9 @@
 
 namespace nap
 {
+	// Forward declares
+	class LovePostersService;
+
     class PlaylistControlComponentInstance;
 
     /**
@@ -113,9 +119,23 @@ namespace nap
          * @return current playlist index
          */
         int getCurrentPlaylistIndex() const            { return mCurrentPlaylistIndex; }
+
+        /**
+         * Returns the time until the playlist switches to the next item
+         * While replaying the time is derived from the next recorded item switch.
+         * @return seconds until the next item, negative when the playlist doesn't advance by itself or no switch follows
+         */
+        float getTimeUntilNextItem() const;
     private:
         void setItemInternal(int index, bool randomize);
 
+        // Activates a playlist item for the given duration
+        void applyItem(int index, Item& item, float duration);
+
+        // Applies a replayed playlist switch, the playlist does not advance by itself while replaying
+        void onEventReplayed(const ControlRecorder::Event& event);
+        Slot<const ControlRecorder::Event&> mEventReplayedSlot = { this, &PlaylistControlComponentInstance::onEventReplayed };
+
         // Selects the next preset in the sequence
         void nextItem();
 
@@ -123,12 +143,14 @@ namespace nap
         void permute(std::vector<PlaylistControlComponentInstance::Item*>& list);
 
 		PlaylistControlComponent* mResource = nullptr;
+		LovePostersService* mService = nullptr;		///< Provides the time step
 
         std::vector<Item> mPlaylist;
         std::vector<Item*> mPermutedPlaylist;
         int mCurrentPlaylistIndex = -1;
         float mCurrentPlaylistItemDuration = 0;
         float mCurrentPlaylistItemElapsedTime = 0;
+        float mReplayItemDuration = -1.0f;            ///< Recorded time between the current and next switch when replaying
         Item* mCurrentPlaylistItem;
 
         bool mRandomizePlaylist = false;
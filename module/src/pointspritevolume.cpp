@@ -1,5 +1,7 @@
 // Local Includes
 #include "pointspritevolume.h"
+#include "lovepostersservice.h"
+#include "spriteshader.h"
 
 // External Includes
 #include <entity.h>
@@ -16,6 +18,10 @@ RTTI_BEGIN_CLASS(nap::PointSpriteVolume)
 	RTTI_PROPERTY("PointScale",				&nap::PointSpriteVolume::mPointScale,				nap::rtti::EPropertyMetaData::Required)
 	RTTI_PROPERTY("PointScaleIntensity",	&nap::PointSpriteVolume::mPointScaleIntensity,		nap::rtti::EPropertyMetaData::Required)
 	RTTI_PROPERTY("TimeScale",				&nap::PointSpriteVolume::mTimeScale,				nap::rtti::EPropertyMetaData::Required)
+	RTTI_PROPERTY("ComputeMaterialInstance",	&nap::PointSpriteVolume::mComputeMaterialInstanceResource,	nap::rtti::EPropertyMetaData::Required)
+	RTTI_PROPERTY("Camera",					&nap::PointSpriteVolume::mCamera,					nap::rtti::EPropertyMetaData::Required)
+	RTTI_PROPERTY("LodPointSize",			&nap::PointSpriteVolume::mLodPointSize,				nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("Generator",				&nap::PointSpriteVolume::mGenerator,				nap::rtti::EPropertyMetaData::Default)
 RTTI_END_CLASS
 
 RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::PointSpriteVolumeInstance)
@@ -24,14 +30,52 @@ RTTI_END_CLASS
 
 namespace nap
 {
+	static constexpr const char* positionBufferName = "PositionBuffer_In";
+	static constexpr const char* hashBufferName = "HashBuffer_In";
+	static constexpr const char* stateOutBufferName = "SpriteBuffer_Out";
+	static constexpr const char* spriteBufferName = "SpriteBuffer";
+	static constexpr const char* indexOutBufferName = "IndexBuffer_Out";
+	static constexpr const char* drawOutBufferName = "DrawBuffer_Out";
+	static constexpr const char* indexBufferName = "IndexBuffer";
+	static constexpr uint drawCommandSize = sizeof(VkDrawIndirectCommand) / sizeof(uint);
+	static constexpr uint stateSize = 4;		///< Number of uint elements per sprite, see sprites.comp
+
+
+	/**
+	 * @return number of particles the buffer holds, -1 if the material has no such buffer.
+	 * Packed buffers hold 'packedSize' elements per particle, 0 when the count isn't a multiple of it.
+	 */
+	static int getParticleCapacity(ComputeMaterialInstance& material, const char* name, int packedSize)
+	{
+		if (auto* binding = material.getOrCreateBuffer<BufferBindingVec4Instance>(name); binding != nullptr)
+			return static_cast<int>(binding->getBuffer().getCount());
+
+		if (auto* binding = material.getOrCreateBuffer<BufferBindingUIntInstance>(name); binding != nullptr)
+		{
+			const int count = static_cast<int>(binding->getBuffer().getCount());
+			return count % packedSize == 0 ? count / packedSize : 0;
+		}
+
+		return -1;
+	}
+
+
 	PointSpriteVolumeInstance::PointSpriteVolumeInstance(EntityInstance& entity, Component& resource) :
 		RenderableMeshComponentInstance(entity, resource),
 		mRenderService(entity.getCore()->getService<RenderService>())
 	{ }
 
 
+	PointSpriteVolumeInstance::~PointSpriteVolumeInstance()
+	{
+		PipelineCache::destroyPipeline(*mRenderService, mComputePipeline);
+	}
+
+
 	bool PointSpriteVolumeInstance::init(nap::utility::ErrorState& errorState)
 	{
+		mService = getEntityInstance()->getCore()->getService<LovePostersService>();
+
 		// Fetch resource
 		mResource = getComponent<PointSpriteVolume>();
 
@@ -47,10 +91,115 @@ namespace nap
 		if (!errorState.check(mTransform != nullptr, "%s: unable to find transform component", mResource->mID.c_str()))
 			return false;
 
+		// Simulation
+		if (!mComputeMaterialInstance.init(*mRenderService, mResource->mComputeMaterialInstanceResource, errorState))
+			return false;
+
+		if (!mService->getPipelineCache().createComputePipeline(mComputeMaterialInstance.getComputeMaterial().getShader(), mComputePipeline, errorState))
+			return false;
+
+		// The mesh determines the number of sprites, the array sizes of both shaders must be defined by the same mesh
+		const auto& mesh = static_cast<ParticleMesh&>(*mResource->mMesh);
+		const auto* sprite_shader = rtti_cast<const SpriteShader>(&mMaterialInstance.getMaterial().getShader());
+		const auto* compute_shader = rtti_cast<const SpriteComputeShader>(&mComputeMaterialInstance.getComputeMaterial().getShader());
+		if (!errorState.check((sprite_shader == nullptr || sprite_shader->mMesh.get() == &mesh) && (compute_shader == nullptr || compute_shader->mMesh.get() == &mesh),
+			"%s: sprite shaders are not compiled for mesh '%s'", mResource->mID.c_str(), mesh.mID.c_str()))
+			return false;
+
+		// Generated particles are sized for the mesh of the generator
+		if (mResource->mGenerator != nullptr)
+		{
+			if (!errorState.check(mResource->mGenerator->mMesh.get() == &mesh, "%s: generator '%s' generates a different mesh",
+				mResource->mID.c_str(), mResource->mGenerator->mID.c_str()))
+				return false;
+
+			if (!mResource->mGenerator->bindBuffers(mComputeMaterialInstance, positionBufferName, hashBufferName, errorState))
+				return false;
+		}
+
+		// Every particle reads one element of each buffer, or its packed equivalent
+		const uint count = mesh.getCount();
+		for (const auto& [name, packed_size] : { std::make_pair(positionBufferName, 2), std::make_pair(hashBufferName, 1) })
+		{
+			const int capacity = getParticleCapacity(mComputeMaterialInstance, name, packed_size);
+			if (!errorState.check(capacity >= 0, "%s: compute material has no vec4 or packed uint buffer '%s'", mResource->mID.c_str(), name))
+				return false;
+
+			if (!errorState.check(capacity == static_cast<int>(count), "%s: buffer '%s' holds %d particles, mesh '%s' has %d",
+				mResource->mID.c_str(), name, capacity, mesh.mID.c_str(), static_cast<int>(count)))
+				return false;
+		}
+		mCount = count;
+
+		// Sprite state, zero initialized: sprites have no size until they are first simulated
+		mStateBuffer = std::make_unique<GPUBufferUInt>(*getEntityInstance()->getCore());
+		mStateBuffer->mID = utility::stringFormat("%s_%s", mID.c_str(), spriteBufferName);
+		mStateBuffer->mUsage = EMemoryUsage::DeviceLocal;
+		mStateBuffer->mCount = count * stateSize;
+		mStateBuffer->mClear = true;
+		if (!mStateBuffer->init(errorState))
+			return false;
+
+		auto* state_out_binding = mComputeMaterialInstance.getOrCreateBuffer<BufferBindingUIntInstance>(stateOutBufferName);
+		if (!errorState.check(state_out_binding != nullptr, "%s: compute material has no buffer '%s'", mResource->mID.c_str(), stateOutBufferName))
+			return false;
+		state_out_binding->setBuffer(*mStateBuffer);
+
+		auto* sprite_binding = mMaterialInstance.getOrCreateBuffer<BufferBindingUIntInstance>(spriteBufferName);
+		if (!errorState.check(sprite_binding != nullptr, "%s: material has no buffer '%s'", mResource->mID.c_str(), spriteBufferName))
+			return false;
+		sprite_binding->setBuffer(*mStateBuffer);
+
+		// Culled sprites, written and drawn in the same frame
+		mIndexBuffer = std::make_unique<GPUBufferUInt>(*getEntityInstance()->getCore());
+		mIndexBuffer->mID = utility::stringFormat("%s_%s", mID.c_str(), indexBufferName);
+		mIndexBuffer->mUsage = EMemoryUsage::DeviceLocal;
+		mIndexBuffer->mCount = count;
+		if (!mIndexBuffer->init(errorState))
+			return false;
+
+		// Reset every frame using a transfer, read as indirect draw command
+		mDrawBuffer = std::make_unique<GPUBufferUInt>(*getEntityInstance()->getCore());
+		mDrawBuffer->mID = utility::stringFormat("%s_%s", mID.c_str(), drawOutBufferName);
+		mDrawBuffer->mUsage = EMemoryUsage::DeviceLocal;
+		mDrawBuffer->mCount = drawCommandSize;
+		mDrawBuffer->mClear = true;
+		mDrawBuffer->ensureUsage(VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+		if (!mDrawBuffer->init(errorState))
+			return false;
+
+		auto* index_out_binding = mComputeMaterialInstance.getOrCreateBuffer<BufferBindingUIntInstance>(indexOutBufferName);
+		auto* draw_out_binding = mComputeMaterialInstance.getOrCreateBuffer<BufferBindingUIntInstance>(drawOutBufferName);
+		if (!errorState.check(index_out_binding != nullptr && draw_out_binding != nullptr, "%s: compute material has no buffer '%s' or '%s'",
+			mResource->mID.c_str(), indexOutBufferName, drawOutBufferName))
+			return false;
+		index_out_binding->setBuffer(*mIndexBuffer);
+		draw_out_binding->setBuffer(*mDrawBuffer);
+
+		auto* index_binding = mMaterialInstance.getOrCreateBuffer<BufferBindingUIntInstance>(indexBufferName);
+		if (!errorState.check(index_binding != nullptr, "%s: material has no buffer '%s'", mResource->mID.c_str(), indexBufferName))
+			return false;
+		index_binding->setBuffer(*mIndexBuffer);
+
+		auto* render_ubo = mMaterialInstance.getOrCreateUniform("UBO");
+		if (!errorState.check(render_ubo != nullptr, "%s: material has no uniform struct 'UBO'", mResource->mID.c_str()))
+			return false;
+		mCulledUniform = render_ubo->getOrCreateUniform<UniformUIntInstance>("culled");
+
 		// Cache uniforms
-		mPointSizeUniform		= mMaterialInstance.getOrCreateUniform("UBO")->getOrCreateUniform<UniformFloatInstance>("pointSize");
-		mPointScaleUniform		= mMaterialInstance.getOrCreateUniform("UBO")->getOrCreateUniform<UniformFloatInstance>("pointScale");
-		mElapsedTimeUniform		= mMaterialInstance.getOrCreateUniform("UBO")->getOrCreateUniform<UniformFloatInstance>("elapsedTime");
+		auto* ubo = mComputeMaterialInstance.getOrCreateUniform("UBO");
+		if (!errorState.check(ubo != nullptr, "%s: compute material has no uniform struct 'UBO'", mResource->mID.c_str()))
+			return false;
+
+		mPointSizeUniform		= ubo->getOrCreateUniform<UniformFloatInstance>("pointSize");
+		mPointScaleUniform		= ubo->getOrCreateUniform<UniformFloatInstance>("pointScale");
+		mElapsedTimeUniform		= ubo->getOrCreateUniform<UniformFloatInstance>("elapsedTime");
+		mLodPointSizeUniform	= ubo->getOrCreateUniform<UniformFloatInstance>("lodPointSize");
+		mInvTargetSizeUniform	= ubo->getOrCreateUniform<UniformVec2Instance>("invTargetSize");
+		mCullProjectionUniform	= ubo->getOrCreateUniform<UniformMat4Instance>("projectionMatrix");
+		mCullViewUniform		= ubo->getOrCreateUniform<UniformMat4Instance>("viewMatrix");
+		mCullModelUniform		= ubo->getOrCreateUniform<UniformMat4Instance>("modelMatrix");
+		mLodPointSizeUniform->setValue(mResource->mLodPointSize);
 
 		return true;
 	}
@@ -58,6 +207,9 @@ namespace nap
 
 	void PointSpriteVolumeInstance::update(double deltaTime)
 	{
+		ProfileScope profile_scope(mService->getUpdateMarker(*this));
+		deltaTime = mService->getTimeStep(deltaTime);
+
 		const auto delta_clock = static_cast<float>(deltaTime) * mResource->mTimeScale->mValue;
 		mElapsedClockTime += delta_clock;
 
@@ -69,6 +221,68 @@ namespace nap
 	}
 
 
+	void PointSpriteVolumeInstance::compute()
+	{
+		if (!isVisible())
+			return;
+
+		// Generate the particles before they are first simulated
+		if (mResource->mGenerator != nullptr)
+			mResource->mGenerator->generate();
+
+		// Cull against the camera as it is drawn this frame.
+		// The sides are only culled once the size of the target it draws into is known.
+		mCullViewMatrix = mCamera->getViewMatrix();
+		mCullProjectionMatrix = mCamera->getRenderProjectionMatrix();
+		mCullProjectionUniform->setValue(mCullProjectionMatrix);
+		mCullViewUniform->setValue(mCullViewMatrix);
+		mCullModelUniform->setValue(mTransform->getGlobalTransform());
+		mInvTargetSizeUniform->setValue(mCullTargetSize.x > 0 && mCullTargetSize.y > 0 ?
+			1.0f / glm::vec2(mCullTargetSize) : glm::vec2(math::max<float>()));
+
+		// Get current command buffer, should be compute.
+		auto command_buffer = mRenderService->getCurrentCommandBuffer();
+
+		// Frames in flight share the queue and the buffers, the queue doesn't order their commands by itself.
+		// Wait for the previous simulation and draws that access the buffers before they are overwritten.
+		VkMemoryBarrier reuse_barrier = {};
+		reuse_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		reuse_barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		reuse_barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+		vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+			VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &reuse_barrier, 0, nullptr, 0, nullptr);
+
+		// Reset the draw command: no vertices, one instance
+		VkBuffer draw_buffer = mDrawBuffer->getBuffer();
+		vkCmdFillBuffer(command_buffer, draw_buffer, 0, sizeof(uint), 0);
+		vkCmdFillBuffer(command_buffer, draw_buffer, sizeof(uint), sizeof(uint), 1);
+
+		VkMemoryBarrier reset_barrier = {};
+		reset_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		reset_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		reset_barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+		vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			0, 1, &reset_barrier, 0, nullptr, 0, nullptr);
+
+		// Get valid descriptor set and pipeline
+		const DescriptorSet& descriptor_set = mComputeMaterialInstance.update();
+		vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, mComputePipeline.mPipeline);
+		vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, mComputePipeline.mLayout, 0, 1, &descriptor_set.mSet, 0, nullptr);
+
+		// One invocation per sprite
+		const uint group_size = mComputeMaterialInstance.getWorkGroupSize().x;
+		vkCmdDispatch(command_buffer, (mCount + group_size - 1) / group_size, 1, 1);
+
+		// Make the state, visible sprites and draw command available to the render passes that draw the volume
+		VkMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+		vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+			0, 1, &barrier, 0, nullptr, 0, nullptr);
+	}
+
+
 	void PointSpriteVolumeInstance::onDraw(IRenderTarget& renderTarget, VkCommandBuffer commandBuffer, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix)
 	{
 		// Get material to work with
@@ -94,6 +308,12 @@ namespace nap
 		if (mCameraWorldPosUniform != nullptr)
 			mCameraWorldPosUniform->setValue(math::extractPosition(glm::inverse(viewMatrix)));
 
+		// Only the visible sprites when drawn from the camera the sprites are culled against, all sprites otherwise
+		const bool culled = viewMatrix == mCullViewMatrix && projectionMatrix == mCullProjectionMatrix;
+		mCulledUniform->setValue(culled ? 1 : 0);
+		if (culled)
+			mCullTargetSize = renderTarget.getBufferSize();
+
 		// Acquire new / unique descriptor set before rendering
 		MaterialInstance& mat_instance = getMaterialInstance();
 		const DescriptorSet& descriptor_set = mat_instance.update();
@@ -120,7 +340,10 @@ namespace nap
 		vkCmdSetLineWidth(commandBuffer, mLineWidth);
 
 		// Draw
-		vkCmdDraw(commandBuffer, mResource->mMesh->getMeshInstance().getNumVertices(), 1, 0, 0);
+		if (culled)
+			vkCmdDrawIndirect(commandBuffer, mDrawBuffer->getBuffer(), 0, 1, sizeof(VkDrawIndirectCommand));
+		else
+			vkCmdDraw(commandBuffer, mCount, 1, 0, 0);
 
 		// Restore line width
 		vkCmdSetLineWidth(commandBuffer, 1.0f);
@@ -1,5 +1,8 @@
 #pragma once
+
+// Local Includes
 #include "particlemesh.h"
+#include "particlegenerator.h"
 
 // External Includes
 #include <renderablemesh.h>
@@ -8,13 +11,40 @@
 #include <uniforminstance.h>
 #include <materialinstance.h>
 #include <parameternumeric.h>
+#include <computematerialinstance.h>
+#include <cameracomponent.h>
+#include <gpubuffer.h>
 
 namespace nap
 {
+	// Forward declares
+	class LovePostersService;
+
 	// Forward declares
 	class PointSpriteVolumeInstance;
 	class TransformComponentInstance;
 
+	/**
+	 * Draws a volume of point sprites that are simulated on the GPU.
+	 *
+	 * The 'ComputeMaterialInstance' evaluates the sprite state once per frame: position including sway, size and rotation.
+	 * The state is a function of time only, it is written to a single internally managed buffer of 16 bytes per sprite:
+	 * the position as three floats, the size and rotation as two half floats. The render material only fetches the state,
+	 * the simulation cost is therefore paid once per frame instead of once per pass.
+	 * The compute material reads the particle position and hash buffers as 'PositionBuffer_In' and 'HashBuffer_In'.
+	 * When a 'Generator' is given its buffers are bound, and generated on the GPU before the sprites are first simulated.
+	 * Otherwise bind them to the compute material, either nap::GPUBufferVec4 or packed nap::GPUBufferUInt buffers,
+	 * see nap::SpriteComputeShader. The nap::ParticleMesh is the single source of the sprite count: the buffers must hold
+	 * exactly its number of particles, the nap::SpriteShader, nap::SpriteComputeShader and generator must refer to it.
+	 *
+	 * The simulation also culls the sprites against the 'Camera': sprites outside of its frustum are dropped and
+	 * sprites smaller than 'LodPointSize' pixels are thinned out. The indices of the remaining sprites are compacted into
+	 * a list, together with the indirect draw command that draws them. The list is only used when the volume is drawn
+	 * from the same camera, all sprites are drawn otherwise, for example into the shadow maps.
+	 *
+	 * Device memory per sprite: 16 bytes of state, 4 bytes of visible index and the particle position and hash.
+	 * Those take 12 bytes when packed and 32 bytes otherwise, 32 bytes per sprite in total when packed.
+	 */
 	class PointSpriteVolume : public RenderableMeshComponent
 	{
 		RTTI_ENABLE(RenderableMeshComponent)
@@ -25,6 +55,10 @@ namespace nap
 		ResourcePtr<ParameterFloat> mPointScale;
 		ResourcePtr<ParameterFloat> mPointScaleIntensity;
 		ResourcePtr<ParameterFloat> mTimeScale;
+		ComputeMaterialInstanceResource mComputeMaterialInstanceResource;	///< Property: 'ComputeMaterialInstance' simulates the sprites
+		ComponentPtr<CameraComponent> mCamera;								///< Property: 'Camera' the sprites are culled against
+		float mLodPointSize = 1.0f;											///< Property: 'LodPointSize' sprites smaller than this number of pixels are thinned out, 0 disables
+		ResourcePtr<ParticleGenerator> mGenerator;							///< Property: 'Generator' optional, generates the particle buffers on the GPU
 	};
 
 
@@ -35,6 +69,7 @@ namespace nap
 
 	public:
 		PointSpriteVolumeInstance(EntityInstance& entity, Component& resource);
+		virtual ~PointSpriteVolumeInstance() override;
 
 		virtual bool init(nap::utility::ErrorState& errorState) override;
 		virtual void update(double deltaTime) override;
@@ -46,17 +81,43 @@ namespace nap
 		*/
 		virtual void onDraw(IRenderTarget& renderTarget, VkCommandBuffer commandBuffer, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix) override;
 
+		/**
+		 * Advances the sprite state to the current frame and culls the sprites against the camera.
+		 * Nothing is dispatched when the volume is hidden.
+		 * Call this in your application render() call, in between nap::RenderService::beginComputeRecording() and
+		 * nap::RenderService::endComputeRecording().
+		 */
+		void compute();
+
 	private:
 		PointSpriteVolume* mResource = nullptr;
+		LovePostersService* mService = nullptr;		///< Provides the time step
 
 		RenderService* mRenderService = nullptr;
 		TransformComponentInstance* mTransform = nullptr;
 
+		ComputeMaterialInstance mComputeMaterialInstance;					///< Simulates the sprites
+		RenderService::Pipeline mComputePipeline;							///< Created from the persistent pipeline cache
+		std::unique_ptr<GPUBufferUInt> mStateBuffer;						///< Sprite state, four elements per sprite
+
+		ComponentInstancePtr<CameraComponent> mCamera = { this, &PointSpriteVolume::mCamera };
+		std::unique_ptr<GPUBufferUInt> mIndexBuffer;						///< Compacted indices of the visible sprites
+		std::unique_ptr<GPUBufferUInt> mDrawBuffer;							///< Indirect draw command of the visible sprites
+		glm::mat4 mCullViewMatrix = glm::mat4(1.0f);						///< View matrix the sprites are culled against this frame
+		glm::mat4 mCullProjectionMatrix = glm::mat4(1.0f);					///< Projection matrix the sprites are culled against this frame
+		glm::ivec2 mCullTargetSize = { 0, 0 };								///< Size of the target the camera draws into, 0 until drawn
+
 		UniformFloatInstance* mPointSizeUniform = nullptr;
 		UniformFloatInstance* mPointScaleUniform = nullptr;
 		UniformFloatInstance* mElapsedTimeUniform = nullptr;
+		UniformFloatInstance* mLodPointSizeUniform = nullptr;
+		UniformVec2Instance* mInvTargetSizeUniform = nullptr;
+		UniformMat4Instance* mCullProjectionUniform = nullptr;
+		UniformMat4Instance* mCullViewUniform = nullptr;
+		UniformMat4Instance* mCullModelUniform = nullptr;
+		UniformUIntInstance* mCulledUniform = nullptr;
 
-		uint mCount = 1;
+		uint mCount = 1;							///< Number of particles drawn, the count of the mesh
 		float mElapsedClockTime = 0.0f;
 	};
 }
@@ -0,0 +1,270 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "profiler.h"
+
+// External Includes
+#include <renderservice.h>
+#include <nap/logger.h>
+#include <utility/stringutils.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+namespace nap
+{
+	static constexpr uint8 queryNone = 0;
+	static constexpr uint8 queryBegun = 1;
+	static constexpr uint8 queryDone = 2;
+
+	Profiler::Profiler(RenderService& renderService) :
+		mRenderService(renderService)
+	{ }
+
+
+	Profiler::~Profiler()
+	{
+		shutdown();
+	}
+
+
+	bool Profiler::init(utility::ErrorState& errorState)
+	{
+		// Timestamps must be supported by the graphics queue
+		const auto& limits = mRenderService.getPhysicalDeviceProperties().limits;
+		uint32 family_count = 0;
+		vkGetPhysicalDeviceQueueFamilyProperties(mRenderService.getPhysicalDevice(), &family_count, nullptr);
+		std::vector<VkQueueFamilyProperties> families(family_count);
+		vkGetPhysicalDeviceQueueFamilyProperties(mRenderService.getPhysicalDevice(), &family_count, families.data());
+
+		const uint32 queue_index = mRenderService.getQueueIndex();
+		const uint32 valid_bits = queue_index < family_count ? families[queue_index].timestampValidBits : 0;
+		mGPUSupported = valid_bits > 0 && limits.timestampPeriod > 0.0f;
+		if (!mGPUSupported)
+		{
+			nap::Logger::warn("Profiler: timestamp queries not supported by graphics queue, GPU timings disabled");
+			return true;
+		}
+
+		mTimestampPeriod = static_cast<double>(limits.timestampPeriod);
+		mTimestampMask = valid_bits >= 64 ? ~0ull : ((1ull << valid_bits) - 1ull);
+
+		// One query pool per frame in flight, two queries per marker
+		VkQueryPoolCreateInfo pool_info = {};
+		pool_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		pool_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		pool_info.queryCount = maxGPUMarkers * 2;
+
+		mFrames.resize(mRenderService.getMaxFramesInFlight());
+		for (auto& frame : mFrames)
+		{
+			if (!errorState.check(vkCreateQueryPool(mRenderService.getDevice(), &pool_info, nullptr, &frame.mPool) == VK_SUCCESS, "Profiler: unable to create timestamp query pool"))
+				return false;
+			frame.mState.resize(maxGPUMarkers, queryNone);
+		}
+		return true;
+	}
+
+
+	void Profiler::shutdown()
+	{
+		if (mFrames.empty())
+			return;
+
+		vkDeviceWaitIdle(mRenderService.getDevice());
+		for (auto& frame : mFrames)
+		{
+			if (frame.mPool != VK_NULL_HANDLE)
+				vkDestroyQueryPool(mRenderService.getDevice(), frame.mPool, nullptr);
+		}
+		mFrames.clear();
+		mCurrentFrame = nullptr;
+	}
+
+
+	ProfileMarker Profiler::registerMarker(const std::string& name, EDomain domain)
+	{
+		const std::string key = utility::stringFormat("%s#%d", name.c_str(), static_cast<int>(domain));
+		auto it = mMarkerMap.find(key);
+		if (it != mMarkerMap.end())
+			return { this, it->second };
+
+		Marker marker;
+		marker.mName = name;
+		marker.mDomain = domain;
+		marker.mSamples.resize(defaultWindowSize, 0.0f);
+		if (domain == EDomain::GPU)
+		{
+			if (mGPUMarkerCount >= maxGPUMarkers)
+			{
+				nap::Logger::warn("Profiler: GPU marker limit of %d reached, '%s' is ignored", maxGPUMarkers, name.c_str());
+				return { };
+			}
+			marker.mQuery = static_cast<int>(mGPUMarkerCount++);
+		}
+
+		int index = static_cast<int>(mMarkers.size());
+		mMarkers.emplace_back(std::move(marker));
+		mMarkerMap.emplace(key, index);
+		return { this, index };
+	}
+
+
+	void Profiler::beginFrame()
+	{
+		if (!mGPUSupported)
+			return;
+
+		auto& frame = mFrames[mRenderService.getCurrentFrameIndex()];
+		if (frame.mReset)
+		{
+			// The frame has completed, read back all markers that were written
+			for (int marker_index : frame.mWritten)
+			{
+				const auto& marker = mMarkers[marker_index];
+				uint64 data[4] = { 0, 0, 0, 0 };
+				VkResult result = vkGetQueryPoolResults(mRenderService.getDevice(), frame.mPool, marker.mQuery * 2, 2, sizeof(data), data,
+					sizeof(uint64) * 2, VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+				if ((result != VK_SUCCESS && result != VK_NOT_READY) || data[1] == 0 || data[3] == 0)
+					continue;
+
+				uint64 begin = data[0] & mTimestampMask;
+				uint64 end = data[2] & mTimestampMask;
+				if (end >= begin)
+					addSample({ this, marker_index }, static_cast<float>(static_cast<double>(end - begin) * mTimestampPeriod * 1.0e-6));
+			}
+		}
+
+		std::fill(frame.mState.begin(), frame.mState.end(), queryNone);
+		frame.mWritten.clear();
+		frame.mReset = false;
+		mCurrentFrame = &frame;
+	}
+
+
+	void Profiler::resetQueries(VkCommandBuffer commandBuffer)
+	{
+		if (!mGPUSupported || mCurrentFrame == nullptr || mCurrentFrame->mReset)
+			return;
+
+		vkCmdResetQueryPool(commandBuffer, mCurrentFrame->mPool, 0, maxGPUMarkers * 2);
+		mCurrentFrame->mReset = true;
+	}
+
+
+	void Profiler::beginGPU(const ProfileMarker& marker, VkCommandBuffer commandBuffer)
+	{
+		if (!mEnabled || !marker.isValid() || mCurrentFrame == nullptr || !mCurrentFrame->mReset)
+			return;
+
+		const int query = mMarkers[marker.mIndex].mQuery;
+		if (query < 0 || mCurrentFrame->mState[query] != queryNone)
+			return;
+
+		vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, mCurrentFrame->mPool, query * 2);
+		mCurrentFrame->mState[query] = queryBegun;
+	}
+
+
+	void Profiler::endGPU(const ProfileMarker& marker, VkCommandBuffer commandBuffer)
+	{
+		if (!mEnabled || !marker.isValid() || mCurrentFrame == nullptr || !mCurrentFrame->mReset)
+			return;
+
+		const int query = mMarkers[marker.mIndex].mQuery;
+		if (query < 0 || mCurrentFrame->mState[query] != queryBegun)
+			return;
+
+		vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, mCurrentFrame->mPool, query * 2 + 1);
+		mCurrentFrame->mState[query] = queryDone;
+		mCurrentFrame->mWritten.emplace_back(marker.mIndex);
+	}
+
+
+	void Profiler::addSample(const ProfileMarker& marker, float milliseconds)
+	{
+		if (!mEnabled || !marker.isValid())
+			return;
+
+		auto& entry = mMarkers[marker.mIndex];
+		entry.mSamples[entry.mHead] = milliseconds;
+		entry.mHead = (entry.mHead + 1) % entry.mSamples.size();
+		entry.mCount = std::min<uint>(entry.mCount + 1, entry.mSamples.size());
+	}
+
+
+	void Profiler::clear()
+	{
+		for (auto& marker : mMarkers)
+		{
+			marker.mHead = 0;
+			marker.mCount = 0;
+		}
+	}
+
+
+	std::vector<Profiler::Stats> Profiler::getStats() const
+	{
+		std::vector<Stats> stats;
+		stats.reserve(mMarkers.size());
+
+		std::vector<float> sorted;
+		for (const auto& marker : mMarkers)
+		{
+			Stats entry;
+			entry.mName = marker.mName;
+			entry.mDomain = marker.mDomain;
+			entry.mSamples = marker.mCount;
+			if (marker.mCount > 0)
+			{
+				const uint size = marker.mSamples.size();
+				entry.mLast = marker.mSamples[(marker.mHead + size - 1) % size];
+
+				sorted.assign(marker.mSamples.begin(), marker.mSamples.begin() + marker.mCount);
+				std::sort(sorted.begin(), sorted.end());
+
+				float sum = 0.0f;
+				for (float sample : sorted)
+					sum += sample;
+
+				auto percentile = [&sorted](float p)
+				{
+					int idx = static_cast<int>(std::ceil(p * static_cast<float>(sorted.size()))) - 1;
+					return sorted[std::clamp<int>(idx, 0, sorted.size() - 1)];
+				};
+
+				entry.mAverage = sum / static_cast<float>(sorted.size());
+				entry.mP95 = percentile(0.95f);
+				entry.mP99 = percentile(0.99f);
+				entry.mMax = sorted.back();
+			}
+			stats.emplace_back(std::move(entry));
+		}
+		return stats;
+	}
+
+
+	bool Profiler::writeCSV(const std::string& path, utility::ErrorState& errorState) const
+	{
+		std::ofstream file(path, std::ios::out | std::ios::trunc);
+		if (!errorState.check(file.is_open(), "Profiler: unable to open file for writing: %s", path.c_str()))
+			return false;
+
+		file << "marker,domain,samples,last_ms,avg_ms,p95_ms,p99_ms,max_ms\n";
+		for (const auto& entry : getStats())
+		{
+			file << entry.mName << ","
+				<< (entry.mDomain == EDomain::GPU ? "gpu" : "cpu") << ","
+				<< entry.mSamples << ","
+				<< entry.mLast << ","
+				<< entry.mAverage << ","
+				<< entry.mP95 << ","
+				<< entry.mP99 << ","
+				<< entry.mMax << "\n";
+		}
+		return errorState.check(file.good(), "Profiler: failed to write file: %s", path.c_str());
+	}
+}
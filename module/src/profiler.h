@@ -0,0 +1,237 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// External Includes
+#include <utility/errorstate.h>
+#include <nap/numeric.h>
+#include <vulkan/vulkan_core.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace nap
+{
+	// Forward declares
+	class RenderService;
+	class Profiler;
+
+	/**
+	 * Handle to a marker registered with the nap::Profiler.
+	 * A default constructed marker is invalid and ignored by the profiler.
+	 */
+	struct ProfileMarker
+	{
+		Profiler*	mProfiler = nullptr;		///< Profiler the marker is registered with
+		int			mIndex = -1;				///< Index of the marker in the profiler
+
+		/**
+		 * @return if the marker is registered
+		 */
+		bool isValid() const					{ return mProfiler != nullptr && mIndex >= 0; }
+	};
+
+
+	/**
+	 * Collects CPU and GPU timings of named markers and keeps a rolling window of samples per marker.
+	 *
+	 * CPU markers are measured using a nap::ProfileScope. GPU markers are measured using Vulkan timestamp queries,
+	 * one query pool is allocated per frame in flight. Results of a frame are resolved when the frame index is reused,
+	 * after nap::RenderService::beginFrame() waited for the frame to complete. GPU timings are disabled when the
+	 * graphics queue does not support timestamps.
+	 *
+	 * Call beginFrame() after nap::RenderService::beginFrame() and resetQueries() at the start of the first
+	 * command buffer that is recorded in a frame, outside of a render pass.
+	 */
+	class NAPAPI Profiler final
+	{
+	public:
+		/**
+		 * Marker domain
+		 */
+		enum class EDomain : uint8
+		{
+			CPU = 0,			///< Measured on the host
+			GPU = 1				///< Measured on the device using timestamp queries
+		};
+
+		/**
+		 * Statistics of a single marker, in milliseconds
+		 */
+		struct Stats
+		{
+			std::string		mName;				///< Marker name
+			EDomain			mDomain;			///< Marker domain
+			uint			mSamples = 0;		///< Number of samples in the window
+			float			mLast = 0.0f;		///< Last sample
+			float			mAverage = 0.0f;	///< Rolling average
+			float			mP95 = 0.0f;		///< 95th percentile
+			float			mP99 = 0.0f;		///< 99th percentile
+			float			mMax = 0.0f;		///< Maximum
+		};
+
+		static constexpr uint maxGPUMarkers = 64;			///< Max number of GPU markers
+		static constexpr uint defaultWindowSize = 300;		///< Number of samples per marker
+
+		Profiler(RenderService& renderService);
+		~Profiler();
+
+		/**
+		 * Creates the timestamp query pools. GPU markers are disabled when timestamps are not supported.
+		 * @param errorState contains the error if initialization fails
+		 * @return if initialization succeeded
+		 */
+		bool init(utility::ErrorState& errorState);
+
+		/**
+		 * Destroys the timestamp query pools
+		 */
+		void shutdown();
+
+		/**
+		 * Registers a marker, returns the existing marker when a marker with the same name and domain exists.
+		 * @param name name of the marker
+		 * @param domain the domain of the marker
+		 * @return handle to the marker
+		 */
+		ProfileMarker registerMarker(const std::string& name, EDomain domain);
+
+		/**
+		 * Resolves the GPU timings of the frame that previously used the current frame index.
+		 * Call this after nap::RenderService::beginFrame().
+		 */
+		void beginFrame();
+
+		/**
+		 * Resets the queries of the current frame.
+		 * Must be recorded before any GPU marker is written, outside of a render pass.
+		 * @param commandBuffer the command buffer to record the reset into
+		 */
+		void resetQueries(VkCommandBuffer commandBuffer);
+
+		/**
+		 * Writes the begin timestamp of a GPU marker.
+		 * @param marker the GPU marker
+		 * @param commandBuffer the currently recording command buffer
+		 */
+		void beginGPU(const ProfileMarker& marker, VkCommandBuffer commandBuffer);
+
+		/**
+		 * Writes the end timestamp of a GPU marker.
+		 * @param marker the GPU marker
+		 * @param commandBuffer the currently recording command buffer
+		 */
+		void endGPU(const ProfileMarker& marker, VkCommandBuffer commandBuffer);
+
+		/**
+		 * Adds a sample to a marker
+		 * @param marker the marker
+		 * @param milliseconds the sample in milliseconds
+		 */
+		void addSample(const ProfileMarker& marker, float milliseconds);
+
+		/**
+		 * Enables or disables the profiler. Markers are ignored when disabled.
+		 * @param enabled if the profiler is enabled
+		 */
+		void setEnabled(bool enabled)							{ mEnabled = enabled; }
+
+		/**
+		 * @return if the profiler is enabled
+		 */
+		bool isEnabled() const									{ return mEnabled; }
+
+		/**
+		 * @return if GPU timings are supported by the device
+		 */
+		bool isGPUSupported() const								{ return mGPUSupported; }
+
+		/**
+		 * Clears all samples
+		 */
+		void clear();
+
+		/**
+		 * Computes the statistics of all markers
+		 * @return statistics of all markers in registration order
+		 */
+		std::vector<Stats> getStats() const;
+
+		/**
+		 * Writes the statistics of all markers to a comma separated file
+		 * @param path the file to write
+		 * @param errorState contains the error if the file can't be written
+		 * @return if the file is written
+		 */
+		bool writeCSV(const std::string& path, utility::ErrorState& errorState) const;
+
+	private:
+		struct Marker
+		{
+			std::string			mName;
+			EDomain				mDomain;
+			std::vector<float>	mSamples;
+			uint				mHead = 0;
+			uint				mCount = 0;
+			int					mQuery = -1;
+		};
+
+		struct FrameQueries
+		{
+			VkQueryPool			mPool = VK_NULL_HANDLE;
+			std::vector<uint8>	mState;					///< Query state per GPU marker
+			std::vector<int>	mWritten;				///< Markers written in the frame
+			bool				mReset = false;			///< If the pool has been reset in the frame
+		};
+
+		RenderService&					mRenderService;
+		std::vector<Marker>				mMarkers;
+		std::unordered_map<std::string, int> mMarkerMap;
+		std::vector<FrameQueries>		mFrames;
+		FrameQueries*					mCurrentFrame = nullptr;
+		uint							mGPUMarkerCount = 0;
+		double							mTimestampPeriod = 1.0;
+		uint64							mTimestampMask = ~0ull;
+		bool							mGPUSupported = false;
+		bool							mEnabled = true;
+	};
+
+
+	/**
+	 * Measures the CPU time between construction and destruction and adds it as a sample to the given marker.
+	 * The marker is copied, it does not have to outlive the scope.
+	 *
+	 * ~~~~~{.cpp}
+	 *	void MyApp::render()
+	 *	{
+	 *		ProfileScope scope(mRenderMarker);
+	 *		...
+	 *	}
+	 * ~~~~~
+	 */
+	class NAPAPI ProfileScope final
+	{
+	public:
+		ProfileScope(ProfileMarker marker) :
+			mMarker(marker), mStart(std::chrono::high_resolution_clock::now())	{ }
+
+		~ProfileScope()
+		{
+			if (mMarker.isValid())
+			{
+				std::chrono::duration<float, std::milli> elapsed = std::chrono::high_resolution_clock::now() - mStart;
+				mMarker.mProfiler->addSample(mMarker, elapsed.count());
+			}
+		}
+
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+
+	private:
+		ProfileMarker mMarker;
+		std::chrono::high_resolution_clock::time_point mStart;
+	};
+}
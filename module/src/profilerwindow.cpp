@@ -0,0 +1,88 @@
+// local includes
+#include "profilerwindow.h"
+#include "lovepostersservice.h"
+
+// nap includes
+#include <imgui/imgui.h>
+#include <nap/core.h>
+#include <nap/logger.h>
+#include <nap/datetime.h>
+#include <imguiservice.h>
+#include <appguiservice.h>
+#include <utility/fileutils.h>
+#include <utility/stringutils.h>
+
+RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::ProfilerWindow)
+    RTTI_CONSTRUCTOR(nap::AppGUIService&)
+	RTTI_PROPERTY("OutputDirectory", &nap::ProfilerWindow::mOutputDirectory, nap::rtti::EPropertyMetaData::Default)
+RTTI_END_CLASS
+
+namespace nap
+{
+	ProfilerWindow::ProfilerWindow(AppGUIService& service) :
+		AppGUIWindow(service),
+		mGuiService(service.getCore().getService<IMGuiService>()),
+		mLovePostersService(service.getCore().getService<LovePostersService>())
+	{ }
+
+
+	void ProfilerWindow::drawContent(double deltaTime)
+	{
+		auto& profiler = mLovePostersService->getProfiler();
+
+		bool enabled = profiler.isEnabled();
+		if (ImGui::Checkbox("Enabled", &enabled))
+			profiler.setEnabled(enabled);
+
+		ImGui::SameLine();
+		if (ImGui::Button("Clear"))
+			profiler.clear();
+
+		ImGui::SameLine();
+		if (ImGui::Button("Save CSV"))
+		{
+			auto stamp = getCurrentDateTime();
+			mLastFile = utility::joinPath({ mOutputDirectory, utility::stringFormat("profile_%d%02d%02d_%02d%02d%02d.csv",
+				stamp.getYear(), static_cast<int>(stamp.getMonth()), stamp.getDayInTheMonth(), stamp.getHour(), stamp.getMinute(), stamp.getSecond()) });
+
+			utility::ErrorState error;
+			if (!profiler.writeCSV(mLastFile, error))
+			{
+				nap::Logger::error(error.toString());
+				mLastFile.clear();
+			}
+		}
+
+		if (!mLastFile.empty())
+			ImGui::TextWrapped("Saved: %s", mLastFile.c_str());
+
+		if (!profiler.isGPUSupported())
+			ImGui::TextWrapped("GPU timings unavailable: timestamp queries not supported");
+
+		ImGui::Dummy({ 0.0f, 2.0f * mGuiService->getScale() });
+
+		// Statistics per marker
+		if (ImGui::BeginTable("Markers", 6, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchProp))
+		{
+			ImGui::TableSetupColumn("Marker");
+			ImGui::TableSetupColumn("Domain");
+			ImGui::TableSetupColumn("Last");
+			ImGui::TableSetupColumn("Avg");
+			ImGui::TableSetupColumn("P95");
+			ImGui::TableSetupColumn("P99");
+			ImGui::TableHeadersRow();
+
+			for (const auto& entry : profiler.getStats())
+			{
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn(); ImGui::TextUnformatted(entry.mName.c_str());
+				ImGui::TableNextColumn(); ImGui::TextUnformatted(entry.mDomain == Profiler::EDomain::GPU ? "GPU" : "CPU");
+				ImGui::TableNextColumn(); ImGui::Text("%.3fms", entry.mLast);
+				ImGui::TableNextColumn(); ImGui::Text("%.3fms", entry.mAverage);
+				ImGui::TableNextColumn(); ImGui::Text("%.3fms", entry.mP95);
+				ImGui::TableNextColumn(); ImGui::Text("%.3fms", entry.mP99);
+			}
+			ImGui::EndTable();
+		}
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+// External Includes
+#include <appguiwidget.h>
+
+namespace nap
+{
+	class IMGuiService;
+	class LovePostersService;
+
+    /**
+     * ProfilerWindow
+	 * Shows the rolling average and 95th and 99th percentile of all CPU and GPU markers of the nap::Profiler.
+	 * The statistics can be written to a comma separated file.
+     */
+    class NAPAPI ProfilerWindow : public AppGUIWindow
+    {
+        RTTI_ENABLE(AppGUIWindow)
+
+    public:
+		ProfilerWindow(AppGUIService& service);
+
+		std::string mOutputDirectory = ".";							///< Property: 'OutputDirectory' directory the CSV files are written to
+
+    protected:
+		/**
+		 * Draw window content
+		 */
+		virtual void drawContent(double deltaTime) override;
+
+		IMGuiService* mGuiService = nullptr;
+		LovePostersService* mLovePostersService = nullptr;
+		std::string mLastFile;
+    };
+
+    using ProfilerWindowObjectCreator = rtti::ObjectCreator<ProfilerWindow, AppGUIService>;
+}
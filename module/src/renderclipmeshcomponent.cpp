@@ -9,7 +9,7 @@
 #include "material.h"
 #include "renderservice.h"
 #include "gpubuffer.h"
-#include "renderglobals.h"
+#include "contourmesh.h"
 
 // External Includes
 #include <entity.h>
@@ -27,6 +27,26 @@ RTTI_END_CLASS
 
 namespace nap
 {
+	/**
+	 * @return if the 'ALPHA_TEST' constant of the clip shaders is enabled, overrides of the instance take precedence
+	 */
+	static bool isAlphaTestEnabled(const MaterialInstanceResource& resource)
+	{
+		static const std::string alpha_test = "ALPHA_TEST";
+		for (const auto& constant : resource.mConstants)
+		{
+			if (constant->mName == alpha_test)
+				return constant->mValue != 0;
+		}
+		for (const auto& constant : resource.mMaterial->mConstants)
+		{
+			if (constant->mName == alpha_test)
+				return constant->mValue != 0;
+		}
+		return true;
+	}
+
+
 	RenderClipMeshComponentInstance::RenderClipMeshComponentInstance(EntityInstance& entity, Component& resource) :
 		RenderableMeshComponentInstance(entity, resource)	{ }
 
@@ -36,7 +56,18 @@ namespace nap
 		if (!RenderableMeshComponentInstance::init(errorState))
 			return false;
 
+		// The alpha test can only be disabled when the mesh doesn't cover transparent pixels
 		auto* resource = getComponent<RenderClipMeshComponent>();
+		auto* contour_mesh = rtti_cast<ContourMesh>(&getMesh());
+		bool inside = contour_mesh != nullptr && contour_mesh->mFit == EContourFit::Inside;
+		bool test_color = isAlphaTestEnabled(resource->mMaterialInstanceResource);
+		bool test_shadow = isAlphaTestEnabled(resource->mShadowMaterialInstanceResource);
+		if (!errorState.check(inside || (test_color && test_shadow), "%s: 'ALPHA_TEST' can only be disabled for a nap::ContourMesh with fit 'Inside'", resource->mID.c_str()))
+			return false;
+
+		if (inside && (test_color || test_shadow))
+			nap::Logger::warn("%s: disable 'ALPHA_TEST' of both materials, the contour mesh only covers opaque pixels", resource->mID.c_str());
+
 		if (!mShadowMaterialInstance.init(*mRenderService, resource->mShadowMaterialInstanceResource, errorState))
 			return false;
 
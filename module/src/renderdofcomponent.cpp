@@ -20,11 +20,19 @@
 #include <nap/core.h>
 #include <orthocameracomponent.h>
 
+RTTI_BEGIN_ENUM(nap::EDOFResolution)
+	RTTI_ENUM_VALUE(nap::EDOFResolution::Full,		"Full"),
+	RTTI_ENUM_VALUE(nap::EDOFResolution::Half,		"Half"),
+	RTTI_ENUM_VALUE(nap::EDOFResolution::Quarter,	"Quarter")
+RTTI_END_ENUM
+
 // nap::RenderDOFComponent run time class definition 
 RTTI_BEGIN_CLASS(nap::RenderDOFComponent)
 	RTTI_PROPERTY("Camera",						&nap::RenderDOFComponent::mCamera,						nap::rtti::EPropertyMetaData::Required)
 	RTTI_PROPERTY("InputTarget",				&nap::RenderDOFComponent::mInputTarget,					nap::rtti::EPropertyMetaData::Required)
 	RTTI_PROPERTY("OutputTexture",				&nap::RenderDOFComponent::mOutputTexture,				nap::rtti::EPropertyMetaData::Required)
+	RTTI_PROPERTY("IntermediateTexture",		&nap::RenderDOFComponent::mIntermediateTexture,			nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("Resolution",					&nap::RenderDOFComponent::mResolution,					nap::rtti::EPropertyMetaData::Default)
 	RTTI_PROPERTY("Aperture",					&nap::RenderDOFComponent::mAperture,					nap::rtti::EPropertyMetaData::Required)
 	RTTI_PROPERTY("FocalLength",				&nap::RenderDOFComponent::mFocalLength,					nap::rtti::EPropertyMetaData::Required)
 	RTTI_PROPERTY("FocusDistance",				&nap::RenderDOFComponent::mFocusDistance,				nap::rtti::EPropertyMetaData::Required)
@@ -45,7 +53,13 @@ namespace nap
 		RenderableComponentInstance(entity, resource),
 		mRenderTargetA(*entity.getCore()),
 		mRenderTargetB(*entity.getCore()),
-		mIntermediateTexture(*entity.getCore()),
+		mInternalTexture(*entity.getCore()),
+		mBlurTexture(*entity.getCore()),
+		mUpsampleTarget(*entity.getCore()),
+		mCoCTexture(*entity.getCore()),
+		mCoCTarget(*entity.getCore()),
+		mTileTexture(*entity.getCore()),
+		mTileTarget(*entity.getCore()),
 		mEmptyMesh(std::make_unique<EmptyMesh>(*entity.getCore()))
 	{ }
 
@@ -91,34 +105,18 @@ namespace nap
 		if (!errorState.check(mDirectionUniform != nullptr, "Missing uniform vec2 'direction' in uniform UBO"))
 			return false;
 
-		mNearFarUniform = ubo_struct->getOrCreateUniform<UniformVec2Instance>(uniform::dof::nearFar);
-		if (!errorState.check(mNearFarUniform != nullptr, "Missing uniform vec2 'nearFar' in uniform UBO"))
-			return false;
-
-		mApertureUniform = ubo_struct->getOrCreateUniform<UniformFloatInstance>(uniform::dof::aperture);
-		if (!errorState.check(mApertureUniform != nullptr, "Missing uniform float 'aperture' in uniform UBO"))
-			return false;
-
-		mFocalLengthUniform = ubo_struct->getOrCreateUniform<UniformFloatInstance>(uniform::dof::focalLength);
-		if (!errorState.check(mFocalLengthUniform != nullptr, "Missing uniform float 'focalLength' in uniform UBO"))
-			return false;
-
-		mFocusDistanceUniform = ubo_struct->getOrCreateUniform<UniformFloatInstance>(uniform::dof::focusDistance);
-		if (!errorState.check(mFocusDistanceUniform != nullptr, "Missing uniform float 'focusDistance' in uniform UBO"))
-			return false;
-
-		mFocusPowerUniform = ubo_struct->getOrCreateUniform<UniformFloatInstance>(uniform::dof::focusPower);
-		if (!errorState.check(mFocusPowerUniform != nullptr, "Missing uniform float 'focusPower' in uniform UBO"))
-			return false;
-
 		// Get color texture sampler
 		mColorTextureSampler = mMaterialInstance.getOrCreateSampler<Sampler2DInstance>(uniform::dof::sampler::colorTexture);
 		if (!errorState.check(mColorTextureSampler != nullptr, "Missing uniform sampler2D 'colorTexture'"))
 			return false;
 
-		// Get depth texture sampler
-		mDepthTextureSampler = mMaterialInstance.getOrCreateSampler<Sampler2DInstance>(uniform::dof::sampler::depthTexture);
-		if (!errorState.check(mDepthTextureSampler != nullptr, "Missing uniform sampler2D 'depthTexture'"))
+		// Get circle of confusion samplers
+		auto* coc_sampler = mMaterialInstance.getOrCreateSampler<Sampler2DInstance>(uniform::dof::sampler::cocTexture);
+		if (!errorState.check(coc_sampler != nullptr, "Missing uniform sampler2D 'cocTexture'"))
+			return false;
+
+		auto* tile_sampler = mMaterialInstance.getOrCreateSampler<Sampler2DInstance>(uniform::dof::sampler::tileTexture);
+		if (!errorState.check(tile_sampler != nullptr, "Missing uniform sampler2D 'tileTexture'"))
 			return false;
 
 		// Create no mesh
@@ -129,22 +127,50 @@ namespace nap
 		if (!errorState.check(mRenderableMesh.isValid(), "%s: unable to create renderable mesh", mID.c_str()))
 			return false;
 
-		// Create intermediate texture
-		mIntermediateTexture.mID = utility::stringFormat("%s_DOF_%s", RTTI_OF(RenderTexture2D).get_name().to_string().c_str(), math::generateUUID().c_str());
-		mIntermediateTexture.mWidth = mResource->mInputTarget->getBufferSize().x;
-		mIntermediateTexture.mHeight = mResource->mInputTarget->getBufferSize().y;
-		mIntermediateTexture.mColorFormat = mResource->mInputTarget->getColorTexture().mColorFormat;
-		mIntermediateTexture.mUsage = Texture2D::EUsage::Static;
-		if (!mIntermediateTexture.init(errorState))
+		// Use the intermediate texture when provided, allowing it to be shared with passes that are not alive at the same time
+		const auto& input_texture = mResource->mInputTarget->getColorTexture();
+		const bool reduced = mResource->mResolution != EDOFResolution::Full;
+		if (mResource->mIntermediateTexture != nullptr && !reduced)
 		{
-			errorState.fail("%s: Failed to initialize internal render target", mIntermediateTexture.mID.c_str());
-			return false;
+			mIntermediateTexture = mResource->mIntermediateTexture.get();
+			if (!errorState.check(mIntermediateTexture->getSize() == input_texture.getSize() && mIntermediateTexture->mColorFormat == input_texture.mColorFormat,
+				"%s: IntermediateTexture '%s' must match the size and format of the input target", mResource->mID.c_str(), mIntermediateTexture->mID.c_str()))
+				return false;
 		}
+		else
+		{
+			// Create intermediate texture, rounded up at reduced resolution
+			const int divisor = static_cast<int>(mResource->mResolution);
+			const glm::ivec2 size = (mResource->mInputTarget->getBufferSize() + divisor - 1) / divisor;
+			if (!initTexture(mInternalTexture, size, input_texture.mColorFormat, errorState))
+				return false;
+
+			if (reduced && !initTexture(mBlurTexture, size, input_texture.mColorFormat, errorState))
+				return false;
+			mIntermediateTexture = &mInternalTexture;
+		}
+
+		// Create circle of confusion textures
+		const glm::ivec2 input_size = mResource->mInputTarget->getBufferSize();
+		if (!initTexture(mCoCTexture, input_size, RenderTexture2D::EFormat::R16, errorState))
+			return false;
+
+		if (!initTexture(mTileTexture, (input_size + dof::tileSize - 1) / dof::tileSize, RenderTexture2D::EFormat::R16, errorState))
+			return false;
+
+		coc_sampler->setTexture(mCoCTexture);
+		tile_sampler->setTexture(mTileTexture);
+
+		// Create render targets, at reduced resolution the vertical pass renders to the blur texture
+		mRenderTargetA.mColorTexture = mIntermediateTexture;
+		mRenderTargetB.mColorTexture = reduced ? &mBlurTexture : mResource->mOutputTexture.get();
+		mUpsampleTarget.mColorTexture = mResource->mOutputTexture;
+		mCoCTarget.mColorTexture = &mCoCTexture;
+		mTileTarget.mColorTexture = &mTileTexture;
+		std::vector<RenderTarget*> targets = { &mCoCTarget, &mTileTarget, &mRenderTargetA, &mRenderTargetB };
+		if (reduced)
+			targets.emplace_back(&mUpsampleTarget);
 
-		// Create render targets
-		mRenderTargetA.mColorTexture = &mIntermediateTexture;
-		mRenderTargetB.mColorTexture = mResource->mOutputTexture;
-		std::vector<RenderTarget*> targets = { &mRenderTargetA, &mRenderTargetB };
 		for (uint i = 0; i< targets.size(); i++)
 		{
 			auto* rt = targets[i];
@@ -159,44 +185,173 @@ namespace nap
 			}
 		}
 
+		if (!initCoC(errorState))
+			return false;
+
+		return reduced ? initUpsample(errorState) : true;
+	}
+
+
+	bool RenderDOFComponentInstance::initPass(Pass& pass, Material* material, utility::ErrorState& errorState)
+	{
+		if (!errorState.check(material != nullptr, "%s: unable to get or create material", mResource->mID.c_str()))
+			return false;
+
+		pass.mResource.mBlendMode = EBlendMode::Opaque;
+		pass.mResource.mDepthMode = EDepthMode::NoReadWrite;
+		pass.mResource.mMaterial = material;
+		if (!pass.mInstance.init(*mRenderService, pass.mResource, errorState))
+			return false;
+
+		pass.mMesh = mRenderService->createRenderableMesh(*mEmptyMesh, pass.mInstance, errorState);
+		return errorState.check(pass.mMesh.isValid(), "%s: unable to create renderable mesh for material: %s", mID.c_str(), material->mID.c_str());
+	}
+
+
+	bool RenderDOFComponentInstance::initTexture(RenderTexture2D& texture, const glm::ivec2& size, RenderTexture2D::EFormat format, utility::ErrorState& errorState)
+	{
+		texture.mID = utility::stringFormat("%s_DOF_%s", RTTI_OF(RenderTexture2D).get_name().to_string().c_str(), math::generateUUID().c_str());
+		texture.mWidth = size.x;
+		texture.mHeight = size.y;
+		texture.mColorFormat = format;
+		texture.mUsage = Texture2D::EUsage::Static;
+		if (!texture.init(errorState))
+		{
+			errorState.fail("%s: Failed to initialize internal render target", texture.mID.c_str());
+			return false;
+		}
+		return true;
+	}
+
+
+	bool RenderDOFComponentInstance::initCoC(utility::ErrorState& errorState)
+	{
+		// Circle of confusion pre-pass
+		if (!initPass(mCoCPass, mRenderService->getOrCreateMaterial<DOFCoCShader>(errorState), errorState))
+			return false;
+
+		UniformStructInstance* ubo_struct = mCoCPass.mInstance.getOrCreateUniform(uniform::dof::uboStruct);
+		if (!errorState.check(ubo_struct != nullptr, "%s: Unable to find uniform UBO struct: %s in material: %s", this->mID.c_str(), uniform::dof::uboStruct, mCoCPass.mInstance.getMaterial().mID.c_str()))
+			return false;
+
+		mNearFarUniform = ubo_struct->getOrCreateUniform<UniformVec2Instance>(uniform::dof::nearFar);
+		if (!errorState.check(mNearFarUniform != nullptr, "Missing uniform vec2 'nearFar' in uniform UBO"))
+			return false;
+
+		// Lens uniforms, copied from their parameters on draw
+		const std::vector<std::pair<const char*, ParameterFloat*>> parameters =
+		{
+			{ uniform::dof::aperture,		mResource->mAperture.get() },
+			{ uniform::dof::focalLength,	mResource->mFocalLength.get() },
+			{ uniform::dof::focusDistance,	mResource->mFocusDistance.get() },
+			{ uniform::dof::focusPower,		mResource->mFocusPower.get() }
+		};
+		for (const auto& parameter : parameters)
+		{
+			auto* lens_uniform = ubo_struct->getOrCreateUniform<UniformFloatInstance>(parameter.first);
+			if (!errorState.check(lens_uniform != nullptr, "Missing uniform float '%s' in uniform UBO", parameter.first))
+				return false;
+			mLensUniforms.emplace_back(lens_uniform, parameter.second);
+		}
+
+		mDepthTextureSampler = mCoCPass.mInstance.getOrCreateSampler<Sampler2DInstance>(uniform::dof::sampler::depthTexture);
+		if (!errorState.check(mDepthTextureSampler != nullptr, "Missing uniform sampler2D 'depthTexture'"))
+			return false;
+
+		// Tile-max pass
+		if (!initPass(mTilePass, mRenderService->getOrCreateMaterial<DOFTileShader>(errorState), errorState))
+			return false;
+
+		auto* coc_sampler = mTilePass.mInstance.getOrCreateSampler<Sampler2DInstance>(uniform::dof::sampler::cocTexture);
+		if (!errorState.check(coc_sampler != nullptr, "Missing uniform sampler2D 'cocTexture'"))
+			return false;
+		coc_sampler->setTexture(mCoCTexture);
+
+		return true;
+	}
+
+
+	bool RenderDOFComponentInstance::initUpsample(utility::ErrorState& errorState)
+	{
+		if (!initPass(mUpsamplePass, mRenderService->getOrCreateMaterial<DOFUpsampleShader>(errorState), errorState))
+			return false;
+
+		auto& instance = mUpsamplePass.mInstance;
+		mUpsampleColorSampler = instance.getOrCreateSampler<Sampler2DInstance>(uniform::dof::sampler::colorTexture);
+		mUpsampleDepthSampler = instance.getOrCreateSampler<Sampler2DInstance>(uniform::dof::sampler::depthTexture);
+		auto* blur_sampler = instance.getOrCreateSampler<Sampler2DInstance>(uniform::dof::sampler::blurTexture);
+		auto* coc_sampler = instance.getOrCreateSampler<Sampler2DInstance>(uniform::dof::sampler::cocTexture);
+		if (!errorState.check(mUpsampleColorSampler != nullptr && mUpsampleDepthSampler != nullptr && blur_sampler != nullptr && coc_sampler != nullptr,
+			"%s: Missing uniform sampler2D 'colorTexture', 'depthTexture', 'blurTexture' or 'cocTexture' in material: %s", mID.c_str(), instance.getMaterial().mID.c_str()))
+			return false;
+
+		blur_sampler->setTexture(mBlurTexture);
+		coc_sampler->setTexture(mCoCTexture);
 		return true;
 	}
 
 
 	void RenderDOFComponentInstance::draw()
 	{
-		mColorTextureSampler->setTexture(mResource->mInputTarget->getColorTexture());
+		// Circle of confusion pre-pass
 		mDepthTextureSampler->setTexture(mResource->mInputTarget->getDepthTexture());
-		mTextureSizeUniform->setValue(mResource->mInputTarget->getColorTexture().getSize());
 		mNearFarUniform->setValue({ mCamera->getNearClippingPlane(), mCamera->getFarClippingPlane() });
-		mApertureUniform->setValue(mResource->mAperture->mValue);
-		mFocalLengthUniform->setValue(mResource->mFocalLength->mValue);
-		mFocusPowerUniform->setValue(mResource->mFocusPower->mValue);
-		mFocusDistanceUniform->setValue(mResource->mFocusDistance->mValue);
-		mDirectionUniform->setValue({1.0f, 0.0f});
+		for (auto& lens_uniform : mLensUniforms)
+			lens_uniform.first->setValue(lens_uniform.second->mValue);
+
+		mCoCTarget.beginRendering();
+		drawMesh(mCoCTarget, mRenderService->getCurrentCommandBuffer(), mCoCPass.mMesh);
+		mCoCTarget.endRendering();
+
+		// Tile-max pass
+		mTileTarget.beginRendering();
+		drawMesh(mTileTarget, mRenderService->getCurrentCommandBuffer(), mTilePass.mMesh);
+		mTileTarget.endRendering();
 
 		// Horizontal pass
+		mColorTextureSampler->setTexture(mResource->mInputTarget->getColorTexture());
+		mTextureSizeUniform->setValue(mResource->mInputTarget->getColorTexture().getSize());
+		mDirectionUniform->setValue({1.0f, 0.0f});
+
 		mRenderTargetA.beginRendering();
 		onDraw(mRenderTargetA, mRenderService->getCurrentCommandBuffer(), {}, {});
 		mRenderTargetA.endRendering();
 
 		// Vertical pass
-		mColorTextureSampler->setTexture(mIntermediateTexture);
+		mColorTextureSampler->setTexture(*mIntermediateTexture);
 		mDirectionUniform->setValue({ 0.0f, 1.0f });
 
 		mRenderTargetB.beginRendering();
 		onDraw(mRenderTargetB, mRenderService->getCurrentCommandBuffer(), {}, {});
 		mRenderTargetB.endRendering();
+
+		if (mResource->mResolution == EDOFResolution::Full)
+			return;
+
+		// Upsample pass, composites the reduced resolution blur with the sharp input
+		mUpsampleColorSampler->setTexture(mResource->mInputTarget->getColorTexture());
+		mUpsampleDepthSampler->setTexture(mResource->mInputTarget->getDepthTexture());
+
+		mUpsampleTarget.beginRendering();
+		drawMesh(mUpsampleTarget, mRenderService->getCurrentCommandBuffer(), mUpsamplePass.mMesh);
+		mUpsampleTarget.endRendering();
 	}
 
 
 	void RenderDOFComponentInstance::onDraw(IRenderTarget& renderTarget, VkCommandBuffer commandBuffer, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix)
+	{
+		drawMesh(renderTarget, commandBuffer, mRenderableMesh);
+	}
+
+
+	void RenderDOFComponentInstance::drawMesh(IRenderTarget& renderTarget, VkCommandBuffer commandBuffer, RenderableMesh& mesh)
 	{
 		utility::ErrorState error_state;
-		RenderService::Pipeline pipeline = mRenderService->getOrCreatePipeline(renderTarget, mRenderableMesh.getMesh(), mMaterialInstance, error_state);
+		MaterialInstance& material_instance = mesh.getMaterialInstance();
+		RenderService::Pipeline pipeline = mRenderService->getOrCreatePipeline(renderTarget, mesh.getMesh(), material_instance, error_state);
 		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.mPipeline);
 
-		const DescriptorSet& descriptor_set = mMaterialInstance.update();
+		const DescriptorSet& descriptor_set = material_instance.update();
 		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.mLayout, 0, 1, &descriptor_set.mSet, 0, nullptr);
 		vkCmdDraw(commandBuffer, 3, 1, 0, 0);
 	}
@@ -19,11 +19,29 @@ namespace nap
 	// Forward Declares
 	class RenderDOFComponentInstance;
 
+	/**
+	 * Resolution of the depth-of-field blur passes, relative to the input target
+	 */
+	enum class EDOFResolution : int
+	{
+		Full	= 1,			///< Blurs at input resolution
+		Half	= 2,			///< Blurs at half the input resolution, upsampled using depth
+		Quarter	= 4				///< Blurs at a quarter of the input resolution, upsampled using depth
+	};
+
 	/**
 	 * Pre- or post-processing effect that applies a depth-of-field effect to the input texture and renders it to the
 	 * specified output render texture. This component manages a custom material based on nap::DOFShader, nap::NoMesh
 	 * and nap::RenderTarget internally.
 	 *
+	 * The circle of confusion is computed once per frame into a 16 bit texture by a pre-pass, followed by a pass that
+	 * stores the maximum circle of confusion of every tile of dof::tileSize pixels. The blur passes read the precomputed
+	 * circle of confusion and skip the kernel for tiles that are fully in focus.
+	 *
+	 * At 'Half' or 'Quarter' resolution both blur passes render into internally managed, reduced resolution textures.
+	 * The result is composited with the sharp input at full resolution using nap::DOFUpsampleShader, which rejects blur
+	 * texels across depth edges to prevent halos around in focus objects. The 'IntermediateTexture' is only used at 'Full' resolution.
+	 *
 	 * Resource-part of RenderDOFComponentInstance.
 	 */
 	class NAPAPI RenderDOFComponent : public RenderableComponent
@@ -34,6 +52,8 @@ namespace nap
 		ComponentPtr<PerspCameraComponent>	mCamera;						///< Property: 'Camera'
 		ResourcePtr<ColorDepthRenderTarget>	mInputTarget;					///< Property: 'InputTarget' the input color target, must be copyable
 		ResourcePtr<RenderTexture2D>		mOutputTexture;					///< Property: 'OutputTexture' the output color texture
+		ResourcePtr<RenderTexture2D>		mIntermediateTexture;			///< Property: 'IntermediateTexture' (optional) texture used for the horizontal pass, allocated internally when not set
+		EDOFResolution						mResolution = EDOFResolution::Full;	///< Property: 'Resolution' resolution of the blur passes relative to the input target
 
 		ResourcePtr<ParameterFloat>			mAperture;
 		ResourcePtr<ParameterFloat>			mFocalLength;
@@ -78,9 +98,30 @@ namespace nap
 		 */
 		Texture2D& getOutputTexture() { return *mResource->mOutputTexture; }
 
+		/**
+		 * Returns the texture that holds the result of the horizontal pass.
+		 * This is either the 'IntermediateTexture' or a texture managed by this component.
+		 * At reduced resolution this is always a texture managed by this component.
+		 * @return the intermediate texture
+		 */
+		Texture2D& getIntermediateTexture() { return *mIntermediateTexture; }
+
+		/**
+		 * Returns the circle of confusion of every input pixel, written by the pre-pass.
+		 * The blur scale is stored divided by 4 in a single 16 bit channel.
+		 * @return the circle of confusion texture
+		 */
+		Texture2D& getCoCTexture() { return mCoCTexture; }
+
+		/**
+		 * Returns the maximum circle of confusion of every tile of dof::tileSize input pixels.
+		 * @return the tile-max circle of confusion texture
+		 */
+		Texture2D& getTileTexture() { return mTileTexture; }
+
 	protected:
 		/**
-		 * Draws the effect full screen to the currently active render target
+		 * Draws the blur full screen to the currently active render target
 		 * @param renderTarget the target to render to.
 		 * @param commandBuffer the currently active command buffer.
 		 * @param viewMatrix ignored
@@ -89,6 +130,41 @@ namespace nap
 		virtual void onDraw(IRenderTarget& renderTarget, VkCommandBuffer commandBuffer, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix) override;
 
 	private:
+		/**
+		 * Full screen pass that is drawn using its own material
+		 */
+		struct Pass
+		{
+			MaterialInstanceResource	mResource;						///< Instance of the material
+			MaterialInstance			mInstance;						///< The MaterialInstance as created from the resource
+			RenderableMesh				mMesh;							///< Empty mesh / material combination
+		};
+
+		/**
+		 * Creates the material instance and renderable mesh of a pass
+		 */
+		bool initPass(Pass& pass, Material* material, utility::ErrorState& errorState);
+
+		/**
+		 * Creates an internally managed render texture
+		 */
+		bool initTexture(RenderTexture2D& texture, const glm::ivec2& size, RenderTexture2D::EFormat format, utility::ErrorState& errorState);
+
+		/**
+		 * Creates the circle of confusion and tile passes
+		 */
+		bool initCoC(utility::ErrorState& errorState);
+
+		/**
+		 * Creates the upsample material and its render target, called at reduced resolution only
+		 */
+		bool initUpsample(utility::ErrorState& errorState);
+
+		/**
+		 * Draws a full screen triangle using the material of the given mesh
+		 */
+		void drawMesh(IRenderTarget& renderTarget, VkCommandBuffer commandBuffer, RenderableMesh& mesh);
+
 		/**
 		 * Link to camera, used to get near and far clipping plane values
 		 */
@@ -100,20 +176,30 @@ namespace nap
 		MaterialInstanceResource	mMaterialInstanceResource;			///< Instance of the material, used to override uniforms for this instance
 		MaterialInstance			mMaterialInstance;					///< The MaterialInstance as created from the resource.
 
-		RenderTexture2D				mIntermediateTexture;				///< Internally managed render texture
+		RenderTexture2D				mInternalTexture;					///< Internally managed render texture, used when no intermediate texture is provided
+		RenderTexture2D*			mIntermediateTexture = nullptr;		///< Render texture of the horizontal pass
 		RenderTarget				mRenderTargetA;						///< Internally managed render target
 		RenderTarget				mRenderTargetB;						///< Internally managed render target
+		RenderTexture2D				mBlurTexture;						///< Reduced resolution result of the vertical pass
+		RenderTarget				mUpsampleTarget;					///< Renders the upsample pass into the output texture
+		RenderTexture2D				mCoCTexture;						///< Circle of confusion of every input pixel
+		RenderTarget				mCoCTarget;							///< Renders the circle of confusion pre-pass
+		RenderTexture2D				mTileTexture;						///< Maximum circle of confusion of every tile
+		RenderTarget				mTileTarget;						///< Renders the tile-max pass
 		RenderableMesh				mRenderableMesh;					///< Mesh / Material combination
 		std::unique_ptr<EmptyMesh>	mEmptyMesh;							///< Empty mesh
 
 		Sampler2DInstance*			mColorTextureSampler = nullptr;		///< Sampler instance for color textures in the blur material
-		Sampler2DInstance*			mDepthTextureSampler = nullptr;		///< Sampler instance for depth textures in the blur material
 		UniformVec2Instance*		mTextureSizeUniform = nullptr;		///< Texture size uniform of the blur material
-		UniformVec2Instance*		mNearFarUniform = nullptr;			///< Near and far clipping plane values of camera
 		UniformVec2Instance*		mDirectionUniform = nullptr;		///< Blur direction
-		UniformFloatInstance*		mApertureUniform = nullptr;			///< Aperture
-		UniformFloatInstance*		mFocalLengthUniform = nullptr;		///< Focal Length
-		UniformFloatInstance*		mFocusDistanceUniform = nullptr;	///< Focus Distance
-		UniformFloatInstance*		mFocusPowerUniform = nullptr;		///< Pocus Power
+
+		Pass						mCoCPass;							///< Circle of confusion pre-pass
+		Pass						mTilePass;							///< Tile-max circle of confusion pass
+		Pass						mUpsamplePass;						///< Composites the reduced resolution blur, at reduced resolution only
+		Sampler2DInstance*			mDepthTextureSampler = nullptr;		///< Sampler instance for depth textures in the circle of confusion material
+		UniformVec2Instance*		mNearFarUniform = nullptr;			///< Near and far clipping plane values of camera
+		std::vector<std::pair<UniformFloatInstance*, ParameterFloat*>> mLensUniforms;	///< Lens uniforms of the circle of confusion material and their parameters
+		Sampler2DInstance*			mUpsampleColorSampler = nullptr;	///< Sharp input color sampler of the upsample material
+		Sampler2DInstance*			mUpsampleDepthSampler = nullptr;	///< Input depth sampler of the upsample material
 	};
 }
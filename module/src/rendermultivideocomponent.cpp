@@ -5,6 +5,8 @@
 // Local Includes
 #include "rendermultivideocomponent.h"
 #include "videoshader.h"
+#include "lovepostersservice.h"
+#include "multivideoshader.h"
 
 // External Includes
 #include <entity.h>
@@ -12,18 +14,36 @@
 #include <nap/core.h>
 #include <renderservice.h>
 #include <renderglobals.h>
+#include <mathutils.h>
+#include <utility/stringutils.h>
 #include <glm/gtc/matrix_transform.hpp>
+#include <cmath>
+#include <algorithm>
+
+RTTI_BEGIN_ENUM(nap::EVideoMode)
+	RTTI_ENUM_VALUE(nap::EVideoMode::Raster,	"Raster"),
+	RTTI_ENUM_VALUE(nap::EVideoMode::Compute,	"Compute"),
+	RTTI_ENUM_VALUE(nap::EVideoMode::Fused,		"Fused")
+RTTI_END_ENUM
 
 // nap::rendervideototexturecomponent run time class definition 
 RTTI_BEGIN_CLASS(nap::RenderMultiVideoComponent, "Renders the output of multiple video players directly to texture without having to define a render target, shader or mesh")
-	RTTI_PROPERTY("OutputTexture",		&nap::RenderMultiVideoComponent::mOutputTexture,			nap::rtti::EPropertyMetaData::Required,	"The texture to render output to")
-	RTTI_PROPERTY("VideoPlayers",		&nap::RenderMultiVideoComponent::mVideoPlayers,				nap::rtti::EPropertyMetaData::Required, "The video player to render to texture")
+	RTTI_PROPERTY("OutputTexture",		&nap::RenderMultiVideoComponent::mOutputTexture,			nap::rtti::EPropertyMetaData::Default,	"The texture to render output to, required in raster and compute mode")
+	RTTI_PROPERTY("VideoPlayers",		&nap::RenderMultiVideoComponent::mVideoPlayers,				nap::rtti::EPropertyMetaData::Required, "The video players to mix, one layer per player")
+	RTTI_PROPERTY("Weights",			&nap::RenderMultiVideoComponent::mWeights,					nap::rtti::EPropertyMetaData::Default,	"The weight of every layer")
 	RTTI_PROPERTY("Samples",			&nap::RenderMultiVideoComponent::mRequestedSamples,			nap::rtti::EPropertyMetaData::Default,	"The number of rasterization samples")
 	RTTI_PROPERTY("ClearColor",			&nap::RenderMultiVideoComponent::mClearColor,				nap::rtti::EPropertyMetaData::Default,	"Initial target clear color")
 	RTTI_PROPERTY("Offset",				&nap::RenderMultiVideoComponent::mOffset,					nap::rtti::EPropertyMetaData::Default,  "Video offset")
 	RTTI_PROPERTY("Scale",				&nap::RenderMultiVideoComponent::mScale,					nap::rtti::EPropertyMetaData::Default,	"Video scale")
-	RTTI_PROPERTY("Blend",				&nap::RenderMultiVideoComponent::mBlendValue,				nap::rtti::EPropertyMetaData::Required,	"Video blend value")
+	RTTI_PROPERTY("Blend",				&nap::RenderMultiVideoComponent::mBlendValue,				nap::rtti::EPropertyMetaData::Default,	"Cross fades two players when no weights are given")
+	RTTI_PROPERTY("FrameRate",			&nap::RenderMultiVideoComponent::mFrameRate,				nap::rtti::EPropertyMetaData::Default,	"Frame rate of the videos, 0 renders every frame a video advances")
+	RTTI_PROPERTY("SuspendInvisible",	&nap::RenderMultiVideoComponent::mSuspendInvisible,			nap::rtti::EPropertyMetaData::Default,	"Stops the players of layers without weight")
+	RTTI_PROPERTY("ResumeTime",			&nap::RenderMultiVideoComponent::mResumeTime,				nap::rtti::EPropertyMetaData::Default,	"Seconds before a playlist switch to resume suspended players")
+	RTTI_PROPERTY("Playlist",			&nap::RenderMultiVideoComponent::mPlaylist,					nap::rtti::EPropertyMetaData::Default,	"Optional playlist that drives the weights")
+	RTTI_PROPERTY("Mode",				&nap::RenderMultiVideoComponent::mMode,						nap::rtti::EPropertyMetaData::Default,	"Raster or compute conversion")
 	RTTI_PROPERTY("MaterialInstance",	&nap::RenderMultiVideoComponent::mMaterialInstanceResource,	nap::rtti::EPropertyMetaData::Default,	"Material instance resource")
+	RTTI_PROPERTY("ComputeMaterialInstance", &nap::RenderMultiVideoComponent::mComputeMaterialInstanceResource, nap::rtti::EPropertyMetaData::Default, "Compute material instance, required in compute mode")
+	RTTI_PROPERTY("FuseInto",			&nap::RenderMultiVideoComponent::mFuseInto,					nap::rtti::EPropertyMetaData::Default,	"Component that samples the layers directly, required in fused mode")
 RTTI_END_CLASS
 
 // nap::rendervideototexturecomponentInstance run time class definition 
@@ -36,6 +56,16 @@ RTTI_END_CLASS
 
 namespace nap
 {
+	static constexpr const char* outputBufferName = "OutputBuffer";
+	static constexpr const char* videoStructName = "video";
+
+	void RenderMultiVideoComponent::getDependentComponents(std::vector<rtti::TypeInfo>& components) const
+	{
+		if (mMode == EVideoMode::Fused)
+			components.emplace_back(RTTI_OF(RenderToTextureComponent));
+	}
+
+
 	/**
 	 * Creates a model matrix based on the dimensions of the given target.
 	 */
@@ -64,14 +94,18 @@ namespace nap
 	}
 
 	/**
-	 * Checks if the sampler with the given name is available on the source material and creates it if so
-	 * @return new or created sampler
+	 * Checks if the sampler array with the given name is available on the source material and creates it if so
+	 * @return new or created sampler array
 	 */
-	static Sampler2DInstance* ensureSampler(const rtti::Object& obj, MaterialInstance& material, const std::string& samplerName, utility::ErrorState& error)
+	static Sampler2DArrayInstance* ensureSampler(const rtti::Object& obj, BaseMaterialInstance& material, const std::string& samplerName, utility::ErrorState& error)
 	{
-		// Get matrix binding
-		auto* sampler = material.getOrCreateSampler<Sampler2DInstance>(samplerName);
-		if (!error.check(sampler != nullptr, "%s: unable to find sampler `%s` in material `%s`", obj.mID.c_str(), samplerName.c_str(), material.getMaterial().mID.c_str()))
+		// Get sampler array binding
+		auto* sampler = material.getOrCreateSampler<Sampler2DArrayInstance>(samplerName);
+		if (!error.check(sampler != nullptr, "%s: unable to find sampler array `%s`", obj.mID.c_str(), samplerName.c_str()))
+			return nullptr;
+
+		if (!error.check(sampler->getNumElements() == RenderMultiVideoComponentInstance::maxLayers, "%s: sampler array `%s` must hold %d textures",
+			obj.mID.c_str(), samplerName.c_str(), RenderMultiVideoComponentInstance::maxLayers))
 			return nullptr;
 
 		return sampler;
@@ -87,26 +121,100 @@ namespace nap
 	{ }
 
 
+	RenderMultiVideoComponentInstance::~RenderMultiVideoComponentInstance()
+	{
+		if (mRenderService != nullptr)
+			PipelineCache::destroyPipeline(*mRenderService, mComputePipeline);
+	}
+
+
 	bool RenderMultiVideoComponentInstance::init(utility::ErrorState& errorState)
 	{
 		if (!RenderableComponentInstance::init(errorState))
 			return false;
+		mService = getEntityInstance()->getCore()->getService<LovePostersService>();
 
 		// Get resource
 		auto* resource = getComponent<RenderMultiVideoComponent>();
 
-		// Extract player
+		// Extract players, one layer per player
+		if (!errorState.check(!resource->mVideoPlayers.empty() && resource->mVideoPlayers.size() <= maxLayers,
+			"%s: expected between 1 and %d video players", resource->mID.c_str(), maxLayers))
+			return false;
+
 		for (uint i = 0; i < resource->mVideoPlayers.size(); i++)
 		{
 			auto& player = resource->mVideoPlayers[i];
 			if (!errorState.check(player != nullptr, "VideoPlayer NULL found"))
 				return false;
 
-			mPlayers[i] = player.get();
-			mVideoMap.emplace(player.get(), i);
+			if (!errorState.check(mVideoMap.emplace(player.get(), i).second, "%s: video player %s is used more than once", resource->mID.c_str(), player->mID.c_str()))
+				return false;
+
+			mPlayers.emplace_back(player.get());
+		}
+
+		// Extract layer weights, fall back to a cross fade of two players
+		if (resource->mWeights.empty())
+		{
+			if (!errorState.check(resource->mBlendValue != nullptr && mPlayers.size() == 2, "%s: no weights, expected 'Blend' and 2 video players", resource->mID.c_str()))
+				return false;
+			mBlendValueParam = resource->mBlendValue.get();
+		}
+		else
+		{
+			if (!errorState.check(resource->mWeights.size() == mPlayers.size(), "%s: expected one weight per video player", resource->mID.c_str()))
+				return false;
+
+			for (const auto& weight : resource->mWeights)
+				mWeightParams.emplace_back(weight.get());
+		}
+		mLayerWeights.resize(mPlayers.size(), 0.0f);
+		mLayerFrames.resize(mPlayers.size(), -1.0);
+		mFrameRate = resource->mFrameRate;
+		mSuspended.resize(mPlayers.size(), false);
+		mSuspendedTimes.resize(mPlayers.size(), 0.0);
+		mSuspendInvisible = resource->mSuspendInvisible;
+		mResumeTime = resource->mResumeTime;
+
+		// Extract render service
+		mRenderService = getEntityInstance()->getCore()->getService<RenderService>();
+		assert(mRenderService != nullptr);
+
+		// Create the resources of the selected conversion
+		mMode = resource->mMode;
+		switch (mMode)
+		{
+		case EVideoMode::Raster:
+			if (!initRaster(errorState))
+				return false;
+			break;
+		case EVideoMode::Compute:
+			if (!initCompute(errorState))
+				return false;
+			break;
+		case EVideoMode::Fused:
+			if (!initFused(errorState))
+				return false;
+			break;
+		}
+
+		// Listen to video selection changes & update textures on init
+		for (auto& player : resource->mVideoPlayers)
+		{
+			player->VideoChanged.connect(mVideoChangedSlot);
+			videoChanged(*player);
 		}
+		update(0.0);
+
+		return true;
+	}
+
 
+	bool RenderMultiVideoComponentInstance::initOutputTexture(utility::ErrorState& errorState)
+	{
 		// Extract output texture to render to and make sure format is correct
+		auto* resource = getComponent<RenderMultiVideoComponent>();
 		mOutputTexture = resource->mOutputTexture.get();
 		if (!errorState.check(mOutputTexture != nullptr, "%s: no output texture", resource->mID.c_str()))
 			return false;
@@ -114,7 +222,17 @@ namespace nap
 		if (!errorState.check(mOutputTexture->mColorFormat == RenderTexture2D::EFormat::RGBA8, "%s: output texture color format is not RGBA8", resource->mID.c_str()))
 			return false;
 
+		return true;
+	}
+
+
+	bool RenderMultiVideoComponentInstance::initRaster(utility::ErrorState& errorState)
+	{
+		if (!initOutputTexture(errorState))
+			return false;
+
 		// Setup render target and initialize
+		auto* resource = getComponent<RenderMultiVideoComponent>();
 		mTarget.mClearColor = resource->mClearColor.convert<RGBAColorFloat>();
 		mTarget.mColorTexture  = resource->mOutputTexture;
 		mTarget.mSampleShading = true;
@@ -134,10 +252,6 @@ namespace nap
 		if (!mPlane.init(errorState))
 			return false;
 
-		// Extract render service
-		mRenderService = getEntityInstance()->getCore()->getService<RenderService>();
-		assert(mRenderService != nullptr);
-
 		// Initialize video material instance, used for rendering video
 		if (!mMaterialInstance.init(*mRenderService, resource->mMaterialInstanceResource, errorState))
 			return false;
@@ -155,70 +269,136 @@ namespace nap
 		if (mModelMatrixUniform == nullptr || mProjectMatrixUniform == nullptr || mViewMatrixUniform == nullptr)
 			return false;
 
-		// Fetch blend and scale uniform
-		auto* ubo_struct = mMaterialInstance.getOrCreateUniform("UBO");
-		if (ubo_struct != nullptr)
-		{
-			mBlendValueUniform = ubo_struct->getOrCreateUniform<UniformFloatInstance>("blend");
-			if (!errorState.check(mBlendValueUniform != nullptr, "Uniform `blend` missing from UBO"))
-				return false;
+		if (!initLayerBindings(mMaterialInstance, errorState))
+			return false;
 
-			auto* offset_uniform = ubo_struct->getOrCreateUniform<UniformVec2Instance>("offset");
-			if (!errorState.check(offset_uniform != nullptr, "Uniform `offset` missing from UBO"))
-				return false;
-			offset_uniform->setValue(resource->mOffset);
+		// Create the renderable mesh, which represents a valid mesh / material combination
+		mRenderableMesh = mRenderService->createRenderableMesh(mPlane, mMaterialInstance, errorState);
+		return mRenderableMesh.isValid();
+	}
 
-			auto* scale_uniform = ubo_struct->getOrCreateUniform<UniformFloatInstance>("scale");
-			if (!errorState.check(scale_uniform != nullptr, "Uniform `scale` missing from UBO"))
-				return false;
-			scale_uniform->setValue(resource->mScale);
-		}
-		mBlendValueParam = resource->mBlendValue.get();
 
-		// Get sampler inputs to update from video material
-		mYSamplerA = ensureSampler(*this, mMaterialInstance, "yTextureA", errorState);
-		mUSamplerA = ensureSampler(*this, mMaterialInstance, "uTextureA", errorState);
-		mVSamplerA = ensureSampler(*this, mMaterialInstance, "vTextureA", errorState);
+	bool RenderMultiVideoComponentInstance::initCompute(utility::ErrorState& errorState)
+	{
+		if (!initOutputTexture(errorState))
+			return false;
 
-		// Get sampler inputs to update from video material
-		mYSamplerB = ensureSampler(*this, mMaterialInstance, "yTextureB", errorState);
-		mUSamplerB = ensureSampler(*this, mMaterialInstance, "uTextureB", errorState);
-		mVSamplerB = ensureSampler(*this, mMaterialInstance, "vTextureB", errorState);
+		// Initialize compute material instance, used for mixing video
+		auto* resource = getComponent<RenderMultiVideoComponent>();
+		if (!mComputeMaterialInstance.init(*mRenderService, resource->mComputeMaterialInstanceResource, errorState))
+			return false;
 
-		if (mYSamplerA == nullptr || mUSamplerA == nullptr || mVSamplerA == nullptr ||
-			mYSamplerB == nullptr || mUSamplerB == nullptr || mVSamplerB == nullptr)
+		// The size of the output buffer is defined by the shader
+		auto* shader = rtti_cast<MultiVideoComputeShader>(&mComputeMaterialInstance.getComputeMaterial().getShader());
+		if (!errorState.check(shader != nullptr && shader->mOutputTexture == resource->mOutputTexture,
+			"%s: compute shader must be a nap::MultiVideoComputeShader of output texture %s", mID.c_str(), mOutputTexture->mID.c_str()))
 			return false;
 
-		// Create the renderable mesh, which represents a valid mesh / material combination
-		mRenderableMesh = mRenderService->createRenderableMesh(mPlane, mMaterialInstance, errorState);
-		if (!mRenderableMesh.isValid())
+		auto& pipeline_cache = getEntityInstance()->getCore()->getService<LovePostersService>()->getPipelineCache();
+		if (!pipeline_cache.createComputePipeline(mComputeMaterialInstance.getComputeMaterial().getShader(), mComputePipeline, errorState))
 			return false;
 
-		// Listen to video selection changes & update textures on init
-		for (auto& player : resource->mVideoPlayers)
-		{
-			player->VideoChanged.connect(mVideoChangedSlot);
-			videoChanged(*player);
-		}
+		if (!initLayerBindings(mComputeMaterialInstance, errorState))
+			return false;
+
+		// One packed RGBA8 value per output pixel
+		const glm::ivec2 size = { mOutputTexture->mWidth, mOutputTexture->mHeight };
+		mOutputBuffer = std::make_unique<GPUBufferUInt>(*getEntityInstance()->getCore());
+		mOutputBuffer->mID = utility::stringFormat("%s_%s", mID.c_str(), outputBufferName);
+		mOutputBuffer->mUsage = EMemoryUsage::DeviceLocal;
+		mOutputBuffer->mCount = size.x * size.y;
+		if (!mOutputBuffer->init(errorState))
+			return false;
+
+		auto* output_binding = mComputeMaterialInstance.getOrCreateBuffer<BufferBindingUIntInstance>(outputBufferName);
+		if (!errorState.check(output_binding != nullptr, "%s: unable to find buffer `%s` in compute material", mID.c_str(), outputBufferName))
+			return false;
+		output_binding->setBuffer(*mOutputBuffer);
+
+		auto* video_struct = mComputeMaterialInstance.getOrCreateUniform(videoStructName);
+		auto* size_uniform = video_struct->getOrCreateUniform<UniformVec2Instance>("size");
+		if (!errorState.check(size_uniform != nullptr, "Uniform `size` missing from %s", videoStructName))
+			return false;
+		size_uniform->setValue(glm::vec2(size));
 
 		return true;
 	}
 
 
+	bool RenderMultiVideoComponentInstance::initFused(utility::ErrorState& errorState)
+	{
+		if (!errorState.check(mFuseInto != nullptr, "%s: fused mode requires a 'FuseInto' component", mID.c_str()))
+			return false;
+
+		return initLayerBindings(mFuseInto->getMaterialInstance(), errorState);
+	}
+
+
+	bool RenderMultiVideoComponentInstance::initLayerBindings(BaseMaterialInstance& material, utility::ErrorState& errorState)
+	{
+		// Fetch layer, offset and scale uniforms
+		auto* resource = getComponent<RenderMultiVideoComponent>();
+		auto* video_struct = material.getOrCreateUniform(videoStructName);
+		if (!errorState.check(video_struct != nullptr, "%s: Unable to find uniform struct `%s`", mID.c_str(), videoStructName))
+			return false;
+
+		mWeightsUniform = video_struct->getOrCreateUniform<UniformFloatArrayInstance>("weights");
+		if (!errorState.check(mWeightsUniform != nullptr && mWeightsUniform->getNumElements() == maxLayers, "Uniform `weights[%d]` missing from %s", maxLayers, videoStructName))
+			return false;
+
+		mLayersUniform = video_struct->getOrCreateUniform<UniformIntArrayInstance>("layers");
+		if (!errorState.check(mLayersUniform != nullptr && mLayersUniform->getNumElements() == maxLayers, "Uniform `layers[%d]` missing from %s", maxLayers, videoStructName))
+			return false;
+
+		mCountUniform = video_struct->getOrCreateUniform<UniformIntInstance>("count");
+		if (!errorState.check(mCountUniform != nullptr, "Uniform `count` missing from %s", videoStructName))
+			return false;
+
+		auto* offset_uniform = video_struct->getOrCreateUniform<UniformVec2Instance>("offset");
+		if (!errorState.check(offset_uniform != nullptr, "Uniform `offset` missing from %s", videoStructName))
+			return false;
+		offset_uniform->setValue(resource->mOffset);
+
+		auto* scale_uniform = video_struct->getOrCreateUniform<UniformFloatInstance>("scale");
+		if (!errorState.check(scale_uniform != nullptr, "Uniform `scale` missing from %s", videoStructName))
+			return false;
+		scale_uniform->setValue(resource->mScale);
+
+		// Get sampler inputs to update from video material
+		mYSamplers = ensureSampler(*this, material, "yTextures", errorState);
+		mUSamplers = ensureSampler(*this, material, "uTextures", errorState);
+		mVSamplers = ensureSampler(*this, material, "vTextures", errorState);
+
+		return mYSamplers != nullptr && mUSamplers != nullptr && mVSamplers != nullptr;
+	}
+
+
 	bool RenderMultiVideoComponentInstance::isSupported(nap::CameraComponentInstance& camera) const
 	{
-		return camera.get_type().is_derived_from(RTTI_OF(OrthoCameraComponentInstance));
+		return mMode == EVideoMode::Raster && camera.get_type().is_derived_from(RTTI_OF(OrthoCameraComponentInstance));
 	}
 
 
 	Texture2D& RenderMultiVideoComponentInstance::getOutputTexture()
 	{
-		return mTarget.getColorTexture();
+		assert(mOutputTexture != nullptr);
+		return *mOutputTexture;
 	}
 
 
 	void RenderMultiVideoComponentInstance::draw()
 	{
+		assert(mMode == EVideoMode::Raster);
+
+		// Keep the previous output when nothing changed
+		if (!mRenderRequired)
+		{
+			mSkippedCount++;
+			return;
+		}
+		mRenderRequired = false;
+		mRenderedCount++;
+
 		// Get current command buffer, should be headless.
 		auto command_buffer = mRenderService->getCurrentCommandBuffer();
 
@@ -235,9 +415,135 @@ namespace nap
 	}
 
 
+	void RenderMultiVideoComponentInstance::compute()
+	{
+		assert(mMode == EVideoMode::Compute);
+
+		// Keep the previous output when nothing changed
+		if (!mRenderRequired)
+		{
+			mSkippedCount++;
+			return;
+		}
+		mRenderRequired = false;
+		mRenderedCount++;
+
+		// Get current command buffer, should be compute.
+		auto command_buffer = mRenderService->getCurrentCommandBuffer();
+
+		// Get valid descriptor set and pipeline
+		const DescriptorSet& descriptor_set = mComputeMaterialInstance.update();
+		vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, mComputePipeline.mPipeline);
+		vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, mComputePipeline.mLayout, 0, 1, &descriptor_set.mSet, 0, nullptr);
+
+		// One invocation per pixel, one workgroup per tile
+		const glm::uvec3 group_size = mComputeMaterialInstance.getWorkGroupSize();
+		const glm::uvec2 size = { mOutputTexture->mWidth, mOutputTexture->mHeight };
+		vkCmdDispatch(command_buffer, (size.x + group_size.x - 1) / group_size.x, (size.y + group_size.y - 1) / group_size.y, 1);
+
+		// Wait for the pixels, the previous content of the texture is discarded
+		VkBufferMemoryBarrier buffer_barrier = {};
+		buffer_barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		buffer_barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		buffer_barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		buffer_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		buffer_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		buffer_barrier.buffer = mOutputBuffer->getBuffer();
+		buffer_barrier.offset = 0;
+		buffer_barrier.size = VK_WHOLE_SIZE;
+
+		VkImageMemoryBarrier image_barrier = {};
+		image_barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		image_barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		image_barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		image_barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		image_barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		image_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		image_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		image_barrier.image = mOutputTexture->getHandle().getImage();
+		image_barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+
+		vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			0, 0, nullptr, 1, &buffer_barrier, 1, &image_barrier);
+
+		// Copy the packed pixels into the output texture, the rows of both are stored bottom to top
+		VkBufferImageCopy region = {};
+		region.bufferOffset = 0;
+		region.bufferRowLength = 0;
+		region.bufferImageHeight = 0;
+		region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+		region.imageOffset = { 0, 0, 0 };
+		region.imageExtent = { size.x, size.y, 1 };
+		vkCmdCopyBufferToImage(command_buffer, mOutputBuffer->getBuffer(), image_barrier.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+		// Make the output visible to the render passes that sample it
+		image_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		image_barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		image_barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		image_barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &image_barrier);
+	}
+
+
 	void RenderMultiVideoComponentInstance::update(double deltaTime)
 	{
-		mBlendValueUniform->setValue(mBlendValueParam->mValue);
+		ProfileScope profile_scope(mService->getUpdateMarker(*this));
+
+		// Gather layer weights
+		std::vector<float> weights(mLayerWeights.size());
+		if (mBlendValueParam != nullptr)
+		{
+			const float blend = math::clamp<float>(mBlendValueParam->mValue, 0.0f, 1.0f);
+			weights[0] = 1.0f - blend;
+			weights[1] = blend;
+		}
+		else
+		{
+			for (int i = 0; i < mWeightParams.size(); i++)
+				weights[i] = math::clamp<float>(mWeightParams[i]->mValue, 0.0f, 1.0f);
+		}
+
+		if (mSuspendInvisible)
+			updateSuspension(weights);
+
+		if (weights != mLayerWeights)
+		{
+			mLayerWeights = std::move(weights);
+			mRenderRequired = true;
+		}
+
+		// Render when an active layer presents a new frame
+		for (int i = 0; i < mPlayers.size(); i++)
+		{
+			const double time = mPlayers[i]->getCurrentTime();
+			const double frame = mFrameRate > 0.0f ? std::floor(time * static_cast<double>(mFrameRate)) : time;
+			if (frame != mLayerFrames[i])
+			{
+				mLayerFrames[i] = frame;
+				mRenderRequired |= mLayerWeights[i] > 0.0f;
+			}
+		}
+
+		if (!mRenderRequired)
+			return;
+
+		float total = 0.0f;
+		for (float weight : mLayerWeights)
+			total += weight;
+
+		// Only layers that contribute are sampled, in order
+		mActiveCount = 0;
+		for (int i = 0; i < mLayerWeights.size(); i++)
+		{
+			if (mLayerWeights[i] <= 0.0f)
+				continue;
+
+			mLayersUniform->setValue(i, mActiveCount);
+			mWeightsUniform->setValue(mLayerWeights[i] / total, mActiveCount);
+			mActiveCount++;
+		}
+		mCountUniform->setValue(mActiveCount);
 	}
 
 
@@ -283,17 +589,49 @@ namespace nap
 		auto it = mVideoMap.find(&player);
 		assert(it != mVideoMap.end());
 
-		if (it->second == 0)
+		mYSamplers->setTexture(it->second, player.getYTexture());
+		mUSamplers->setTexture(it->second, player.getUTexture());
+		mVSamplers->setTexture(it->second, player.getVTexture());
+		mSuspendedTimes[it->second] = 0.0;
+		mRenderRequired = true;
+	}
+
+
+	void RenderMultiVideoComponentInstance::updateSuspension(const std::vector<float>& weights)
+	{
+		// Resume ahead of a playlist switch, giving the players time to decode their first frames
+		bool prefetch = false;
+		if (mPlaylist != nullptr)
 		{
-			mYSamplerA->setTexture(player.getYTexture());
-			mUSamplerA->setTexture(player.getUTexture());
-			mVSamplerA->setTexture(player.getVTexture());
+			const float remaining = mPlaylist->getTimeUntilNextItem();
+			prefetch = remaining >= 0.0f && remaining <= mResumeTime;
 		}
-		else
+
+		for (int i = 0; i < mPlayers.size(); i++)
 		{
-			mYSamplerB->setTexture(player.getYTexture());
-			mUSamplerB->setTexture(player.getUTexture());
-			mVSamplerB->setTexture(player.getVTexture());
+			auto& player = *mPlayers[i];
+			const bool required = prefetch || weights[i] > 0.0f || weights[i] != mLayerWeights[i];
+			if (!required && !mSuspended[i])
+			{
+				// Only suspend players that are playing, stopped players are left alone
+				if (!player.isPlaying())
+					continue;
+
+				mSuspendedTimes[i] = player.getCurrentTime();
+				player.stop();
+				mSuspended[i] = true;
+			}
+			else if (required && mSuspended[i])
+			{
+				player.play(mSuspendedTimes[i]);
+				mSuspended[i] = false;
+			}
 		}
 	}
+
+
+	int RenderMultiVideoComponentInstance::getSuspendedCount() const
+	{
+		return static_cast<int>(std::count(mSuspended.begin(), mSuspended.end(), true));
+	}
 }
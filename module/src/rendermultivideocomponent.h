@@ -6,6 +6,7 @@
 
 // Local Includes
 #include "videoplayer.h"
+#include "playlistcontrolcomponent.h"
 
 // External Includes
 #include <component.h>
@@ -16,36 +17,91 @@
 #include <rendertarget.h>
 #include <color.h>
 #include <materialinstance.h>
+#include <computematerialinstance.h>
+#include <gpubuffer.h>
 #include <renderablemesh.h>
 #include <parameternumeric.h>
+#include <componentptr.h>
+#include <rendertotexturecomponent.h>
 
 namespace nap
 {
 	// Forward Declares
 	class RenderMultiVideoComponentInstance;
+	class LovePostersService;
 
 	/**
-	 * Renders the output of a nap::VideoPlayer directly to texture without having to define a render target, shader or mesh.
-	 * This components converts the YUV textures, generated by the nap::VideoPlayer, into an RGB texture.
+	 * How the video layers are converted and mixed
+	 */
+	enum class EVideoMode : int
+	{
+		Raster	= 0,			///< Draws a plane into the output texture
+		Compute	= 1,			///< Writes packed RGBA8 pixels into the output buffer using a compute shader, copied into the output texture
+		Fused	= 2				///< Binds the layers to the material of another component, which samples them directly
+	};
+
+	/**
+	 * Mixes the output of any number of nap::VideoPlayer objects directly to texture without having to define a render target, shader or mesh.
+	 * This components converts the YUV textures, generated by every nap::VideoPlayer, into a single RGB texture.
 	 * Call draw() in your application render() call, in between nap::RenderService::beginHeadlessRecording() 
 	 * and nap::RenderService::endHeadlessRecording().
 	 * The video frame is scaled to fit the dimensions of the given output texture.
 	 * It is still possible to render this component using the render service, although only orthographic cameras are supported.
+	 *
+	 * Every video player is a layer with its own 'Weight' parameter, the layers are mixed in a single pass and normalized by their total weight.
+	 * Layers with a weight of zero are not sampled. When no weights are given, two players are cross faded using the 'Blend' parameter.
+	 * The YUV textures of the players are bound to the 'yTextures', 'uTextures' and 'vTextures' sampler arrays, refer to 'multivideo.frag'.
+	 *
+	 * The output texture is only rendered again when an active layer presents a new frame or a weight changes.
+	 * nap::VideoPlayer doesn't report decoded frames: a new frame is assumed every 1 / 'FrameRate' seconds of playback.
+	 * Use the highest frame rate of the videos, no frame is dropped. When 0, every frame a playing video advances is rendered.
+	 *
+	 * When 'SuspendInvisible' is enabled, players of layers without weight are stopped until their weight changes.
+	 * All suspended players resume 'ResumeTime' seconds before the 'Playlist' switches items, the next item might fade them in.
+	 * Without a playlist a player resumes as soon as its weight changes, the first frames of the fade might be late.
+	 *
+	 * In 'Compute' mode the layers are mixed by the 'ComputeMaterialInstance' into a storage buffer instead, one packed RGBA8
+	 * value per pixel of the output texture, rows bottom to top. There is no rasterization, sample shading or resolve.
+	 * Call compute() in between nap::RenderService::beginComputeRecording() and nap::RenderService::endComputeRecording().
+	 * The buffer is copied into the output texture in the same recording, components that sample the output texture work
+	 * in both modes. The compute shader must be a nap::MultiVideoComputeShader of the output texture, refer to 'multivideo.comp'.
+	 * Compute materials can only bind storage buffers, not storage images, and render textures aren't created with storage
+	 * usage: the shader can't write the output texture directly, hence the buffer and the full resolution copy.
+	 * The buffer and copy cost memory bandwidth that raster mode doesn't, benchmark both before switching a scene to compute.
+	 *
+	 * In 'Fused' mode nothing is rendered: the samplers and 'video' uniform struct of the layers are bound to the material
+	 * of the 'FuseInto' component instead. Its shader includes 'multivideo.glslinc' and calls mixLayers() where it would sample
+	 * the output texture, which removes the intermediate texture and its render pass, refer to 'compositestencilfused.frag'.
 	 */
 	class NAPAPI RenderMultiVideoComponent : public RenderableComponent
 	{
 		RTTI_ENABLE(RenderableComponent)
 		DECLARE_COMPONENT(RenderMultiVideoComponent, RenderMultiVideoComponentInstance)
 	public:
-		std::array<ResourcePtr<VideoPlayer>, 2>	mVideoPlayers;										///< Property: 'VideoPlayers' the video players to render to texture
+		std::vector<ResourcePtr<VideoPlayer>>	mVideoPlayers;										///< Property: 'VideoPlayers' the video players to mix, one layer per player
+		std::vector<ResourcePtr<ParameterFloat>> mWeights;											///< Property: 'Weights' the weight of every layer, 0-1
 		ResourcePtr<RenderTexture2D>			mOutputTexture = nullptr;							///< Property: 'OutputTexture' the RGB8 texture to render output to
 		ERasterizationSamples					mRequestedSamples = ERasterizationSamples::One;		///< Property: 'Samples' The number of samples used during Rasterization. For better results enable 'SampleShading'
 		RGBAColor8								mClearColor = { 255, 255, 255, 255 };				///< Property: 'ClearColor' the color that is used to clear the render target
 		glm::vec2								mOffset = { 0.0f, 0.0f };							///< Property: 'Offset' the video offset
 		float									mScale = 1.0f;										///< Property: 'Scale' the video scale
-		ResourcePtr<ParameterFloat>				mBlendValue;										///< Property: 'BlendValue' the video blend value
+		ResourcePtr<ParameterFloat>				mBlendValue;										///< Property: 'Blend' cross fades two players when no weights are given
+		float									mFrameRate = 0.0f;									///< Property: 'FrameRate' frame rate of the videos, 0 renders every frame a video advances
+		bool									mSuspendInvisible = false;							///< Property: 'SuspendInvisible' stops the players of layers without weight
+		float									mResumeTime = 1.0f;									///< Property: 'ResumeTime' seconds before a playlist switch to resume suspended players
+		ComponentPtr<PlaylistControlComponent>	mPlaylist;											///< Property: 'Playlist' optional playlist that drives the weights
 
+		EVideoMode								mMode = EVideoMode::Raster;							///< Property: 'Mode' raster or compute conversion
 		MaterialInstanceResource				mMaterialInstanceResource;							///< Resource used to initialize the material instance
+		ComputeMaterialInstanceResource			mComputeMaterialInstanceResource;					///< Property: 'ComputeMaterialInstance' compute material, required in compute mode
+		ComponentPtr<RenderToTextureComponent>	mFuseInto;											///< Property: 'FuseInto' component that samples the layers directly, required in fused mode
+
+		/**
+		 * In fused mode the fused component is initialized first, its material is required.
+		 * Raster and compute mode don't depend on other components.
+		 * @param components the components this object depends on
+		 */
+		virtual void getDependentComponents(std::vector<rtti::TypeInfo>& components) const override;
 	};
 
 
@@ -61,7 +117,10 @@ namespace nap
 	{
 		RTTI_ENABLE(RenderableComponentInstance)
 	public:
+		static constexpr int maxLayers = 8;			///< Maximum number of video layers, must match MAX_LAYERS in 'multivideo.frag'
+
 		RenderMultiVideoComponentInstance(EntityInstance& entity, Component& resource);
+		virtual ~RenderMultiVideoComponentInstance() override;
 
 		/**
 		 * Initializes the component based on resource.
@@ -76,12 +135,51 @@ namespace nap
 		virtual bool isSupported(nap::CameraComponentInstance& camera) const override;
 
 		/**
-		 * Update blend value uniform
+		 * Updates the layer weights and selects the layers to sample
 		 */
 		void update(double deltaTime) override;
 
 		/**
-		 * Returns the rendered RGB video texture.
+		 * @return number of video layers
+		 */
+		int getLayerCount() const								{ return static_cast<int>(mPlayers.size()); }
+
+		/**
+		 * @return number of layers with a weight above zero, sampled when drawn
+		 */
+		int getActiveLayerCount() const							{ return mActiveCount; }
+
+		/**
+		 * @param index layer index
+		 * @return the current weight of a layer, 0-1
+		 */
+		float getWeight(int index) const						{ assert(index < mLayerWeights.size()); return mLayerWeights[index]; }
+
+		/**
+		 * @return if the output texture is out of date and rendered on the next draw()
+		 */
+		bool isRenderRequired() const							{ return mRenderRequired; }
+
+		/**
+		 * @return number of draw() calls that rendered the output texture
+		 */
+		int getRenderedCount() const							{ return mRenderedCount; }
+
+		/**
+		 * @return number of draw() calls that kept the previous output texture
+		 */
+		int getSkippedCount() const								{ return mSkippedCount; }
+
+		/**
+		 * @return number of players that are currently suspended
+		 */
+		int getSuspendedCount() const;
+
+		ComponentInstancePtr<PlaylistControlComponent> mPlaylist = { this, &RenderMultiVideoComponent::mPlaylist };
+		ComponentInstancePtr<RenderToTextureComponent> mFuseInto = { this, &RenderMultiVideoComponent::mFuseInto };
+
+		/**
+		 * Returns the rendered RGB video texture, not available in fused mode.
 		 * @return the rendered RGB video texture.
 		 */
 		Texture2D& getOutputTexture();
@@ -93,9 +191,27 @@ namespace nap
 		 * nap::RenderService::endHeadlessRecording(). Do not call this function outside 
 		 * of a headless recording pass, ie: when rendering to a window. 
 		 * Alternatively, you can use the render service to render this component, see onDraw()
+		 * Nothing is rendered when no active layer presented a new frame and no weight changed since the previous draw.
 		 */
 		void draw();
 
+		/**
+		 * Mixes the video layers into the output buffer using the compute material and copies it into the output texture.
+		 * Compute mode only. Call this in your application render() call, in between nap::RenderService::beginComputeRecording()
+		 * and nap::RenderService::endComputeRecording(). Nothing is dispatched when the output is up to date.
+		 */
+		void compute();
+
+		/**
+		 * @return the conversion mode
+		 */
+		EVideoMode getMode() const								{ return mMode; }
+
+		/**
+		 * @return the packed RGBA8 output of the compute mode, one value per pixel of the output texture
+		 */
+		GPUBufferUInt& getOutputBuffer()						{ assert(mOutputBuffer != nullptr); return *mOutputBuffer; }
+
 	protected:
 		/**
 		 * Draws the video frame full screen to the currently active render target,
@@ -108,7 +224,7 @@ namespace nap
 		virtual void onDraw(IRenderTarget& renderTarget, VkCommandBuffer commandBuffer, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix) override;
 
 	private:
-		std::array<VideoPlayer*, 2>	mPlayers;										///< Video players to render	
+		std::vector<VideoPlayer*>	mPlayers;										///< Video players to render, one per layer
 		RenderTexture2D*			mOutputTexture = nullptr;						///< Texture currently bound by target
 		RGBColorFloat				mClearColor = { 0.0f, 0.0f, 0.0f };				///< Target Clear Color
 		RenderTarget				mTarget;										///< Target video is rendered into
@@ -117,20 +233,35 @@ namespace nap
 		RenderableMesh				mRenderableMesh;								///< Valid Plane / Material combination
 		ShaderConstant				mScaleConstant;
 		RenderService*				mRenderService = nullptr;						///< Pointer to the render service
+		LovePostersService*			mService = nullptr;								///< Measures the update
 		UniformMat4Instance*		mModelMatrixUniform = nullptr;					///< Model matrix uniform in the material
 		UniformMat4Instance*		mProjectMatrixUniform = nullptr;				///< Projection matrix uniform in the material
 		UniformMat4Instance*		mViewMatrixUniform = nullptr;					///< View matrix uniform in the material
 		UniformStructInstance*		mMVPStruct = nullptr;							///< model view projection struct
-		ParameterFloat*				mBlendValueParam = nullptr;
-		UniformFloatInstance*		mBlendValueUniform = nullptr;					///< Video blend value uniform
-		Sampler2DInstance*			mYSamplerA = nullptr;							///< Video material Y sampler A
-		Sampler2DInstance*			mUSamplerA = nullptr;							///< Video material U sampler A
-		Sampler2DInstance*			mVSamplerA = nullptr;							///< Video material V sampler A
-		Sampler2DInstance*			mYSamplerB = nullptr;							///< Video material Y sampler B
-		Sampler2DInstance*			mUSamplerB = nullptr;							///< Video material U sampler B
-		Sampler2DInstance*			mVSamplerB = nullptr;							///< Video material V sampler B
+		ParameterFloat*				mBlendValueParam = nullptr;						///< Cross fades layer 0 and 1 when there are no weight parameters
+		std::vector<ParameterFloat*> mWeightParams;									///< Weight parameter of every layer
+		std::vector<float>			mLayerWeights;									///< Current weight of every layer
+		int							mActiveCount = 0;								///< Number of layers with a weight above zero
+		std::vector<double>			mLayerFrames;									///< Last presented frame, or time when the frame rate is unknown, of every layer
+		float						mFrameRate = 0.0f;								///< Frame rate of the videos
+		bool						mRenderRequired = true;							///< If the output texture is out of date
+		int							mRenderedCount = 0;								///< Number of rendered draws
+		int							mSkippedCount = 0;								///< Number of skipped draws
+		bool						mSuspendInvisible = false;						///< If players of layers without weight are stopped
+		float						mResumeTime = 1.0f;								///< Seconds before a playlist switch to resume players
+		std::vector<bool>			mSuspended;										///< If the player of a layer is suspended
+		std::vector<double>			mSuspendedTimes;								///< Playback position of a suspended player
+		EVideoMode					mMode = EVideoMode::Raster;						///< Conversion mode
+		ComputeMaterialInstance		mComputeMaterialInstance;						///< The compute material instance, compute mode only
+		RenderService::Pipeline		mComputePipeline;								///< Created from the persistent pipeline cache, compute mode only
+		std::unique_ptr<GPUBufferUInt> mOutputBuffer;								///< Packed RGBA8 output, compute mode only
+		UniformFloatArrayInstance*	mWeightsUniform = nullptr;						///< Normalized weight of every active layer
+		UniformIntArrayInstance*	mLayersUniform = nullptr;						///< Layer index of every active layer
+		UniformIntInstance*			mCountUniform = nullptr;						///< Number of active layers
+		Sampler2DArrayInstance*		mYSamplers = nullptr;							///< Video material Y sampler array
+		Sampler2DArrayInstance*		mUSamplers = nullptr;							///< Video material U sampler array
+		Sampler2DArrayInstance*		mVSamplers = nullptr;							///< Video material V sampler array
 		glm::mat4x4					mModelMatrix;									///< Computed model matrix, used to scale plane to fit target bounds
-		bool						mDirty = true;									///< If the model matrix needs to be re-computed
 
 		std::map<VideoPlayer*, int> mVideoMap;
 
@@ -141,6 +272,37 @@ namespace nap
 		 */
 		void videoChanged(VideoPlayer& player);
 
+		/**
+		 * Stops the players of layers without weight and resumes them when required.
+		 * @param weights the new layer weights, compared against the current weights
+		 */
+		void updateSuspension(const std::vector<float>& weights);
+
+		/**
+		 * Fetches the layer uniforms and samplers of the material used for conversion
+		 */
+		bool initLayerBindings(BaseMaterialInstance& material, utility::ErrorState& errorState);
+
+		/**
+		 * Creates the plane and material used to draw the layers
+		 */
+		bool initRaster(utility::ErrorState& errorState);
+
+		/**
+		 * Creates the compute material and output buffer
+		 */
+		bool initCompute(utility::ErrorState& errorState);
+
+		/**
+		 * Binds the layers to the material of the fused component
+		 */
+		bool initFused(utility::ErrorState& errorState);
+
+		/**
+		 * Validates the output texture, required in raster and compute mode
+		 */
+		bool initOutputTexture(utility::ErrorState& errorState);
+
 		// Called when video selection changes
 		nap::Slot<VideoPlayer&> mVideoChangedSlot = { this, &RenderMultiVideoComponentInstance::videoChanged };
 	};
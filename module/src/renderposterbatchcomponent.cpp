@@ -0,0 +1,368 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "renderposterbatchcomponent.h"
+#include "lovepostersservice.h"
+
+// External Includes
+#include <entity.h>
+#include <renderservice.h>
+#include <renderglobals.h>
+#include <transformcomponent.h>
+#include <mathutils.h>
+#include <samplerinstance.h>
+#include <nap/core.h>
+#include <nap/logger.h>
+#include <utility/stringutils.h>
+#include <algorithm>
+
+RTTI_BEGIN_CLASS(nap::RenderPosterBatchComponent)
+	RTTI_PROPERTY("Posters",				&nap::RenderPosterBatchComponent::mPosters,							nap::rtti::EPropertyMetaData::Required)
+	RTTI_PROPERTY("ShadowMaterialInstance",	&nap::RenderPosterBatchComponent::mShadowMaterialInstanceResource,	nap::rtti::EPropertyMetaData::Required)
+RTTI_END_CLASS
+
+RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::RenderPosterBatchComponentInstance)
+	RTTI_CONSTRUCTOR(nap::EntityInstance&, nap::Component&)
+RTTI_END_CLASS
+
+namespace nap
+{
+	static constexpr const char* transformBufferName = "TransformBuffer";
+	static constexpr const char* instanceBufferName = "InstanceBuffer";
+	static constexpr const char* textureSamplerName = "colorTextures";
+
+	/**
+	 * Merged poster meshes, created and owned by the batch
+	 */
+	class PosterBatchMesh : public IMesh
+	{
+	public:
+		PosterBatchMesh(RenderService& renderService) : mMeshInstance(renderService)	{ }
+
+		virtual MeshInstance& getMeshInstance() override								{ return mMeshInstance; }
+		virtual const MeshInstance& getMeshInstance() const override					{ return mMeshInstance; }
+
+	private:
+		MeshInstance mMeshInstance;
+	};
+
+	void RenderPosterBatchComponent::getDependentComponents(std::vector<rtti::TypeInfo>& components) const
+	{
+		components.emplace_back(RTTI_OF(RenderClipMeshComponent));
+	}
+
+
+	RenderPosterBatchComponentInstance::RenderPosterBatchComponentInstance(EntityInstance& entity, Component& resource) :
+		RenderableMeshComponentInstance(entity, resource)	{ }
+
+
+	bool RenderPosterBatchComponentInstance::init(utility::ErrorState& errorState)
+	{
+		if (!RenderableMeshComponentInstance::init(errorState))
+			return false;
+		mService = getEntityInstance()->getCore()->getService<LovePostersService>();
+
+		auto* resource = getComponent<RenderPosterBatchComponent>();
+		if (!errorState.check(mPosterComponents.size() <= maxPosters, "%s: too many posters, %d is the maximum", mID.c_str(), maxPosters))
+			return false;
+
+		if (!mShadowMaterialInstance.init(*mRenderService, resource->mShadowMaterialInstanceResource, errorState))
+			return false;
+
+		// Gather posters and their textures
+		std::vector<Texture2D*> textures;
+		for (auto& poster_component : mPosterComponents)
+		{
+			auto* sampler = poster_component->getMaterialInstance().findSampler("colorTexture");
+			if (!errorState.check(sampler != nullptr && sampler->get_type().is_derived_from(RTTI_OF(Sampler2DInstance)),
+				"%s: poster '%s' has no 'colorTexture' sampler", mID.c_str(), poster_component->mID.c_str()))
+				return false;
+
+			auto& texture = static_cast<Sampler2DInstance*>(sampler)->getTexture();
+			auto it = std::find(textures.begin(), textures.end(), &texture);
+			if (it == textures.end())
+			{
+				if (!errorState.check(textures.size() < maxTextures, "%s: too many poster textures, %d is the maximum", mID.c_str(), maxTextures))
+					return false;
+				it = textures.emplace(textures.end(), &texture);
+			}
+
+			Poster poster;
+			poster.mTexture = static_cast<int>(it - textures.begin());
+			poster.mTransform = poster_component->getEntityInstance()->findComponent<TransformComponentInstance>();
+			if (!errorState.check(poster.mTransform != nullptr, "%s: poster '%s' has no transform", mID.c_str(), poster_component->mID.c_str()))
+				return false;
+
+			auto* ubo = poster_component->getMaterialInstance().findUniform("UBO");
+			poster.mAlpha = ubo != nullptr ? ubo->findUniform<UniformFloatInstance>("alpha") : nullptr;
+
+			mOrder.emplace_back(static_cast<int>(mPosters.size()));
+			mPosters.emplace_back(poster);
+		}
+
+		// Merge the poster meshes
+		if (!initMesh(errorState))
+			return false;
+
+		// Create instance buffers, written every frame
+		auto& core = *getEntityInstance()->getCore();
+		mTransformBuffer = std::make_unique<GPUBufferMat4>(core);
+		mTransformBuffer->mID = utility::stringFormat("%s_%s", mID.c_str(), transformBufferName);
+		mTransformBuffer->mUsage = EMemoryUsage::DynamicWrite;
+		mTransformBuffer->mCount = maxPosters;
+		if (!mTransformBuffer->init(errorState))
+			return false;
+
+		mInstanceBuffer = std::make_unique<GPUBufferVec4>(core);
+		mInstanceBuffer->mID = utility::stringFormat("%s_%s", mID.c_str(), instanceBufferName);
+		mInstanceBuffer->mUsage = EMemoryUsage::DynamicWrite;
+		mInstanceBuffer->mCount = maxPosters;
+		if (!mInstanceBuffer->init(errorState))
+			return false;
+
+		mTransforms.resize(maxPosters, glm::identity<glm::mat4>());
+		mInstances.resize(maxPosters, glm::vec4(0.0f));
+
+		// Bind textures and buffers
+		if (!initMaterial(getMaterialInstance(), textures, errorState))
+			return false;
+
+		if (!initMaterial(mShadowMaterialInstance, textures, errorState))
+			return false;
+
+		UniformStructInstance* mvp_struct = mShadowMaterialInstance.getOrCreateUniform(uniform::mvpStruct);
+		if (mvp_struct != nullptr)
+		{
+			mShadowViewMatUniform = mvp_struct->getOrCreateUniform<UniformMat4Instance>(uniform::viewMatrix);
+			mShadowProjectMatUniform = mvp_struct->getOrCreateUniform<UniformMat4Instance>(uniform::projectionMatrix);
+		}
+
+		// The posters are drawn by this component from now on
+		for (auto& poster_component : mPosterComponents)
+			poster_component->setVisible(false);
+
+		return true;
+	}
+
+
+	bool RenderPosterBatchComponentInstance::initMesh(utility::ErrorState& errorState)
+	{
+		if (mPosterComponents.empty())
+			return true;
+
+		const MeshInstance& first_mesh = mPosterComponents.front()->getMesh().getMeshInstance();
+		auto mesh = std::make_unique<PosterBatchMesh>(*mRenderService);
+		MeshInstance& mesh_instance = mesh->getMeshInstance();
+
+		std::vector<glm::vec3> positions;
+		std::vector<glm::vec3> normals;
+		std::vector<glm::vec3> uvs;
+		std::vector<uint32> indices;
+		std::vector<const IMesh*> meshes;
+
+		for (int i = 0; i < mPosterComponents.size(); i++)
+		{
+			// Posters that share a mesh share a range
+			const IMesh& poster_mesh = mPosterComponents[i]->getMesh();
+			auto it = std::find(meshes.begin(), meshes.end(), &poster_mesh);
+			if (it != meshes.end())
+			{
+				mPosters[i].mRange = static_cast<int>(it - meshes.begin());
+				continue;
+			}
+
+			const MeshInstance& source = poster_mesh.getMeshInstance();
+			if (!errorState.check(source.getDrawMode() == EDrawMode::Triangles, "%s: mesh '%s' is not a triangle mesh", mID.c_str(), poster_mesh.mID.c_str()))
+				return false;
+
+			if (!errorState.check(source.getCullMode() == first_mesh.getCullMode() && source.getPolygonMode() == first_mesh.getPolygonMode(),
+				"%s: mesh '%s' has a different cull or polygon mode than the first poster mesh", mID.c_str(), poster_mesh.mID.c_str()))
+				return false;
+
+			const auto* position = source.findAttribute<glm::vec3>(vertexid::position);
+			const auto* normal = source.findAttribute<glm::vec3>(vertexid::normal);
+			const auto* uv = source.findAttribute<glm::vec3>(vertexid::getUVName(0));
+			if (!errorState.check(position != nullptr && normal != nullptr && uv != nullptr,
+				"%s: mesh '%s' requires a position, normal and uv attribute", mID.c_str(), poster_mesh.mID.c_str()))
+				return false;
+
+			// Indices are offset by the vertices of the preceding meshes
+			const uint32 first_vertex = static_cast<uint32>(positions.size());
+			Range range;
+			range.mFirstIndex = static_cast<uint32>(indices.size());
+			for (int shape = 0; shape < source.getNumShapes(); shape++)
+			{
+				for (uint32 index : source.getShape(shape).getIndices())
+					indices.emplace_back(first_vertex + index);
+			}
+			range.mIndexCount = static_cast<uint32>(indices.size()) - range.mFirstIndex;
+
+			positions.insert(positions.end(), position->getData().begin(), position->getData().end());
+			normals.insert(normals.end(), normal->getData().begin(), normal->getData().end());
+			uvs.insert(uvs.end(), uv->getData().begin(), uv->getData().end());
+
+			mPosters[i].mRange = static_cast<int>(mRanges.size());
+			mRanges.emplace_back(range);
+			meshes.emplace_back(&poster_mesh);
+		}
+
+		mesh->mID = utility::stringFormat("%s_Mesh", mID.c_str());
+		mesh_instance.setNumVertices(static_cast<int>(positions.size()));
+		mesh_instance.setUsage(EMemoryUsage::Static);
+		mesh_instance.setDrawMode(EDrawMode::Triangles);
+		mesh_instance.setCullMode(first_mesh.getCullMode());
+		mesh_instance.setPolygonMode(first_mesh.getPolygonMode());
+
+		mesh_instance.getOrCreateAttribute<glm::vec3>(vertexid::position).setData(positions);
+		mesh_instance.getOrCreateAttribute<glm::vec3>(vertexid::normal).setData(normals);
+		mesh_instance.getOrCreateAttribute<glm::vec3>(vertexid::getUVName(0)).setData(uvs);
+
+		MeshShape& shape = mesh_instance.createShape();
+		shape.setIndices(indices.data(), indices.size());
+		if (!mesh_instance.init(errorState))
+			return false;
+		mMesh = std::move(mesh);
+
+		mColorMesh = mRenderService->createRenderableMesh(*mMesh, getMaterialInstance(), errorState);
+		if (!errorState.check(mColorMesh.isValid(), "%s: unable to create renderable poster mesh", mID.c_str()))
+			return false;
+
+		mShadowMesh = mRenderService->createRenderableMesh(*mMesh, mShadowMaterialInstance, errorState);
+		return errorState.check(mShadowMesh.isValid(), "%s: unable to create shadow renderable poster mesh", mID.c_str());
+	}
+
+
+	bool RenderPosterBatchComponentInstance::initMaterial(MaterialInstance& material, const std::vector<Texture2D*>& textures, utility::ErrorState& errorState)
+	{
+		auto* sampler = material.getOrCreateSampler<Sampler2DArrayInstance>(textureSamplerName);
+		if (!errorState.check(sampler != nullptr, "%s: material '%s' has no '%s' sampler array", mID.c_str(), material.getMaterial().mID.c_str(), textureSamplerName))
+			return false;
+
+		if (!errorState.check(sampler->getNumElements() >= textures.size(), "%s: '%s' sampler array is too small, %d textures required",
+			mID.c_str(), textureSamplerName, static_cast<int>(textures.size())))
+			return false;
+
+		for (int i = 0; i < textures.size(); i++)
+			sampler->setTexture(i, *textures[i]);
+
+		auto* transform_binding = material.getOrCreateBuffer<BufferBindingMat4Instance>(transformBufferName);
+		if (!errorState.check(transform_binding != nullptr, "%s: material '%s' has no '%s'", mID.c_str(), material.getMaterial().mID.c_str(), transformBufferName))
+			return false;
+		transform_binding->setBuffer(*mTransformBuffer);
+
+		auto* instance_binding = material.getOrCreateBuffer<BufferBindingVec4Instance>(instanceBufferName);
+		if (!errorState.check(instance_binding != nullptr, "%s: material '%s' has no '%s'", mID.c_str(), material.getMaterial().mID.c_str(), instanceBufferName))
+			return false;
+		instance_binding->setBuffer(*mInstanceBuffer);
+
+		return true;
+	}
+
+
+	void RenderPosterBatchComponentInstance::update(double deltaTime)
+	{
+		ProfileScope profile_scope(mService->getUpdateMarker(*this));
+
+		// Transforms are final when drawn, upload on first draw
+		mDirty = true;
+	}
+
+
+	bool RenderPosterBatchComponentInstance::upload(utility::ErrorState& errorState)
+	{
+		// Back to front, matches the z-sort of the color pass
+		std::sort(mOrder.begin(), mOrder.end(), [this](int a, int b)
+		{
+			return mPosters[a].mTransform->getGlobalTransform()[3].z < mPosters[b].mTransform->getGlobalTransform()[3].z;
+		});
+
+		mDraws.clear();
+		for (uint32 instance = 0; instance < mOrder.size(); instance++)
+		{
+			const auto& poster = mPosters[mOrder[instance]];
+			mTransforms[instance] = poster.mTransform->getGlobalTransform();
+			mInstances[instance] = { static_cast<float>(poster.mTexture), poster.mAlpha != nullptr ? poster.mAlpha->getValue() : 1.0f, 0.0f, 0.0f };
+
+			// Extend the previous draw when the poster shares its mesh
+			if (!mDraws.empty() && mDraws.back().mRange == poster.mRange)
+				mDraws.back().mInstanceCount++;
+			else
+				mDraws.push_back({ poster.mRange, instance, 1 });
+		}
+
+		if (!mTransformBuffer->setData(mTransforms, errorState))
+			return false;
+
+		return mInstanceBuffer->setData(mInstances, errorState);
+	}
+
+
+	void RenderPosterBatchComponentInstance::onDraw(IRenderTarget& renderTarget, VkCommandBuffer commandBuffer, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix)
+	{
+		if (mPosters.empty())
+			return;
+
+		// Upload instance data once per frame
+		utility::ErrorState error_state;
+		if (mDirty)
+		{
+			if (!upload(error_state))
+			{
+				nap::Logger::error("%s: %s", mID.c_str(), error_state.toString().c_str());
+				return;
+			}
+			mDirty = false;
+		}
+
+		bool use_shadow_material = (renderTarget.getDepthFormat() != VK_FORMAT_UNDEFINED) &&
+								   (renderTarget.getColorFormat() == VK_FORMAT_UNDEFINED);
+
+		if (use_shadow_material)
+		{
+			// Set mvp matrices if present in material
+			if (mShadowProjectMatUniform != nullptr)
+				mShadowProjectMatUniform->setValue(projectionMatrix);
+
+			if (mShadowViewMatUniform != nullptr)
+				mShadowViewMatUniform->setValue(viewMatrix);
+		}
+		else
+		{
+			// Set mvp matrices if present in material
+			if (mProjectMatUniform != nullptr)
+				mProjectMatUniform->setValue(projectionMatrix);
+
+			if (mViewMatUniform != nullptr)
+				mViewMatUniform->setValue(viewMatrix);
+
+			if (mCameraWorldPosUniform != nullptr)
+				mCameraWorldPosUniform->setValue(math::extractPosition(glm::inverse(viewMatrix)));
+		}
+
+		// Acquire a single descriptor set for all posters
+		MaterialInstance& mat_instance = use_shadow_material ? mShadowMaterialInstance : getMaterialInstance();
+		const DescriptorSet& descriptor_set = mat_instance.update();
+
+		auto& renderable_mesh = use_shadow_material ? mShadowMesh : mColorMesh;
+		RenderService::Pipeline pipeline = mRenderService->getOrCreatePipeline(renderTarget, renderable_mesh.getMesh(), mat_instance, error_state);
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.mPipeline);
+		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.mLayout, 0, 1, &descriptor_set.mSet, 0, nullptr);
+
+		// Bind the merged vertex and index buffers once
+		const std::vector<VkBuffer>& vertexBuffers = renderable_mesh.getVertexBuffers();
+		const std::vector<VkDeviceSize>& vertexBufferOffsets = renderable_mesh.getVertexBufferOffsets();
+		vkCmdBindVertexBuffers(commandBuffer, 0, vertexBuffers.size(), vertexBuffers.data(), vertexBufferOffsets.data());
+
+		const IndexBuffer& index_buffer = renderable_mesh.getMesh().getMeshInstance().getGPUMesh().getIndexBuffer(0);
+		vkCmdBindIndexBuffer(commandBuffer, index_buffer.getBuffer(), 0, VK_INDEX_TYPE_UINT32);
+
+		// Draw every run of posters at the offset of its mesh
+		for (const auto& draw : mDraws)
+		{
+			const auto& range = mRanges[draw.mRange];
+			vkCmdDrawIndexed(commandBuffer, range.mIndexCount, draw.mInstanceCount, range.mFirstIndex, 0, draw.mFirstInstance);
+		}
+	}
+}
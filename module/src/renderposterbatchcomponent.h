@@ -0,0 +1,147 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// Local Includes
+#include "renderclipmeshcomponent.h"
+
+// External Includes
+#include <renderablemeshcomponent.h>
+#include <componentptr.h>
+#include <gpubuffer.h>
+
+namespace nap
+{
+	// Forward declares
+	class RenderPosterBatchComponentInstance;
+	class TransformComponentInstance;
+	class LovePostersService;
+
+	/**
+	 * Draws a collection of poster clip meshes from a single vertex and index buffer, with one pipeline and descriptor set per pass.
+	 *
+	 * The posters are hidden on initialization and drawn by this component instead. The meshes of all posters, for example
+	 * a shared plane or a contour mesh per poster, are merged into one buffer on initialization. Every poster mesh must be a
+	 * static triangle mesh with a position, normal and uv attribute, and share the cull and polygon mode of the first poster.
+	 * Posters are sorted back to front on the z-axis, consecutive posters that share a mesh are drawn with one instanced call.
+	 *
+	 * The texture bound to the 'colorTexture' sampler of every poster is assigned to the 'colorTextures' sampler array of the batch materials.
+	 * The model matrix of every poster is stored in the 'TransformBuffer', the texture index and alpha in the 'InstanceBuffer'.
+	 * Refer to 'posterbatch.vert' and 'posterbatchshadow.vert' for compatible shaders.
+	 *
+	 * The alpha of a poster is read from the 'UBO.alpha' uniform of its material instance, when overridden.
+	 * This component should carry the tags of the posters it draws.
+	 * The mesh of this component is used to validate the material, posters may use any mesh with compatible vertex attributes.
+	 */
+	class NAPAPI RenderPosterBatchComponent : public RenderableMeshComponent
+	{
+		RTTI_ENABLE(RenderableMeshComponent)
+		DECLARE_COMPONENT(RenderPosterBatchComponent, RenderPosterBatchComponentInstance)
+	public:
+		/**
+		 * Posters are initialized before the batch
+		 * @param components the components this object depends on
+		 */
+		virtual void getDependentComponents(std::vector<rtti::TypeInfo>& components) const override;
+
+		std::vector<ComponentPtr<RenderClipMeshComponent>>	mPosters;							///< Property: 'Posters' the posters to draw
+		MaterialInstanceResource							mShadowMaterialInstanceResource;	///< Property: 'ShadowMaterialInstance' instanced shadow material
+	};
+
+
+	/**
+	 * Instance part of the poster batch component.
+	 * Uploads the transforms of all posters once per frame and draws them instanced.
+	 */
+	class NAPAPI RenderPosterBatchComponentInstance : public RenderableMeshComponentInstance
+	{
+		RTTI_ENABLE(RenderableMeshComponentInstance)
+	public:
+		static constexpr int maxPosters = 256;		///< Maximum number of posters, must match MAX_POSTERS in the batch shaders
+		static constexpr int maxTextures = 32;		///< Maximum number of unique poster textures, must match MAX_TEXTURES in the batch shaders
+
+		RenderPosterBatchComponentInstance(EntityInstance& entity, Component& resource);
+
+		/**
+		 * Gathers the posters, creates the instance buffers and hides the posters
+		 * @param errorState contains the error if initialization fails
+		 * @return if initialization succeeded
+		 */
+		virtual bool init(utility::ErrorState& errorState) override;
+
+		/**
+		 * Marks the instance data for upload
+		 * @param deltaTime time in between frames in seconds
+		 */
+		virtual void update(double deltaTime) override;
+
+		/**
+		 * @return number of batched posters
+		 */
+		int getPosterCount() const								{ return static_cast<int>(mPosters.size()); }
+
+		/**
+		 * @return number of instanced draw calls per pass in the last frame
+		 */
+		int getDrawCount() const								{ return static_cast<int>(mDraws.size()); }
+
+		std::vector<ComponentInstancePtr<RenderClipMeshComponent>> mPosterComponents = initComponentInstancePtr(this, &RenderPosterBatchComponent::mPosters);
+
+	protected:
+		/**
+		 * Draws all posters, one instanced draw call per run of posters that share a mesh
+		 */
+		virtual void onDraw(IRenderTarget& renderTarget, VkCommandBuffer commandBuffer, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix) override;
+
+	private:
+		// A batched poster
+		struct Poster
+		{
+			TransformComponentInstance* mTransform = nullptr;
+			UniformFloatInstance* mAlpha = nullptr;			///< Poster alpha, nullptr when not overridden
+			int mTexture = 0;								///< Index in the sampler array
+			int mRange = 0;									///< Index of the mesh range
+		};
+
+		// Indices of a poster mesh in the merged mesh
+		struct Range
+		{
+			uint32 mFirstIndex = 0;
+			uint32 mIndexCount = 0;
+		};
+
+		// Consecutive posters that share a mesh, drawn in a single call
+		struct Draw
+		{
+			int mRange = 0;
+			uint32 mFirstInstance = 0;
+			uint32 mInstanceCount = 0;
+		};
+
+		bool initMesh(utility::ErrorState& errorState);
+		bool initMaterial(MaterialInstance& material, const std::vector<Texture2D*>& textures, utility::ErrorState& errorState);
+		bool upload(utility::ErrorState& errorState);
+
+		std::vector<Poster> mPosters;
+		std::vector<int> mOrder;							///< Posters back to front
+		std::vector<Range> mRanges;
+		std::vector<Draw> mDraws;
+
+		std::unique_ptr<IMesh> mMesh;						///< All poster meshes, merged
+		RenderableMesh mColorMesh;
+		RenderableMesh mShadowMesh;
+
+		MaterialInstance mShadowMaterialInstance;
+		UniformMat4Instance* mShadowViewMatUniform = nullptr;
+		UniformMat4Instance* mShadowProjectMatUniform = nullptr;
+
+		std::unique_ptr<GPUBufferMat4> mTransformBuffer;
+		std::unique_ptr<GPUBufferVec4> mInstanceBuffer;
+		std::vector<glm::mat4> mTransforms;
+		std::vector<glm::vec4> mInstances;
+		bool mDirty = true;
+		LovePostersService* mService = nullptr;		///< Measures the update
+	};
+}
@@ -0,0 +1,58 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "renderregistry.h"
+
+namespace nap
+{
+	void RenderRegistry::setRoot(EntityInstance* root)
+	{
+		mRoot = root;
+		mDirty = true;
+	}
+
+
+	const RenderRegistry::RenderableList& RenderRegistry::getRenderables()
+	{
+		if (mDirty)
+			rebuild();
+		return mRenderables;
+	}
+
+
+	const RenderRegistry::RenderableList& RenderRegistry::getRenderables(RenderMask mask)
+	{
+		if (mDirty)
+			rebuild();
+
+		// No filtering possible, the render service interprets the mask
+		if (mask == 0 || mask == mask::all)
+			return mRenderables;
+
+		auto it = mBuckets.find(mask);
+		if (it != mBuckets.end())
+			return it->second;
+
+		// Untagged components are kept, the render service decides how to treat them
+		auto& bucket = mBuckets[mask];
+		for (auto* comp : mRenderables)
+		{
+			const auto comp_mask = comp->getRenderMask();
+			if (comp_mask == 0 || (comp_mask & mask) != 0)
+				bucket.emplace_back(comp);
+		}
+		return bucket;
+	}
+
+
+	void RenderRegistry::rebuild()
+	{
+		mRenderables.clear();
+		mBuckets.clear();
+		if (mRoot != nullptr)
+			mRoot->getComponentsOfTypeRecursive<RenderableComponentInstance>(mRenderables);
+		mDirty = false;
+	}
+}
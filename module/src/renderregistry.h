@@ -0,0 +1,71 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// External Includes
+#include <rendercomponent.h>
+#include <rendertag.h>
+#include <entity.h>
+#include <unordered_map>
+#include <vector>
+
+namespace nap
+{
+	/**
+	 * Caches the renderable components of an entity hierarchy, bucketed by render mask.
+	 *
+	 * Gathering the renderable components of a hierarchy requires a recursive walk over all entities and components.
+	 * The registry performs this walk once and keeps the result until it is invalidated, for example when resources
+	 * are (re)loaded or entities are spawned or removed. A bucket for a specific render mask is created on first
+	 * request and contains all components that could pass that mask, in hierarchy order.
+	 *
+	 * Components that are toggled invisible remain in the buckets: visibility is evaluated when rendering.
+	 * Always pass the same mask to nap::RenderService::renderObjects(), buckets are a pre-filter, not a replacement.
+	 */
+	class NAPAPI RenderRegistry final
+	{
+	public:
+		using RenderableList = std::vector<RenderableComponentInstance*>;
+
+		/**
+		 * Sets the root of the hierarchy to gather renderable components from and invalidates the registry.
+		 * @param root the root entity, nullptr to clear the registry
+		 */
+		void setRoot(EntityInstance* root);
+
+		/**
+		 * @return the root of the hierarchy, nullptr if not set
+		 */
+		EntityInstance* getRoot() const							{ return mRoot; }
+
+		/**
+		 * Invalidates all cached lists, they are rebuilt on next request.
+		 * Call this when entities or components are added to or removed from the hierarchy.
+		 */
+		void invalidate()										{ mDirty = true; }
+
+		/**
+		 * @return all renderable components in the hierarchy
+		 */
+		const RenderableList& getRenderables();
+
+		/**
+		 * Returns all renderable components in the hierarchy that could pass the given mask.
+		 * All renderable components are returned when the mask is 0 or nap::mask::all.
+		 * The returned list remains valid until the registry is invalidated.
+		 * @param mask the render mask
+		 * @return all renderable components that could pass the given mask
+		 */
+		const RenderableList& getRenderables(RenderMask mask);
+
+	private:
+		void rebuild();
+
+		EntityInstance*									mRoot = nullptr;		///< Root of the hierarchy
+		RenderableList									mRenderables;			///< All renderable components
+		std::unordered_map<RenderMask, RenderableList>	mBuckets;				///< Renderable components per mask
+		bool											mDirty = true;			///< If the lists require a rebuild
+	};
+}
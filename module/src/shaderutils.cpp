@@ -0,0 +1,39 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local includes
+#include "shaderutils.h"
+
+// External includes
+#include <renderservice.h>
+#include <renderadvancedservice.h>
+#include <utility/fileutils.h>
+
+namespace nap
+{
+	namespace utility
+	{
+		bool insertShaderDefines(std::string& source, const std::string& path, const std::string& defines, utility::ErrorState& errorState)
+		{
+			const size_t version_end = source.find('\n', source.find("#version"));
+			if (!errorState.check(version_end != std::string::npos, "Missing #version directive in %s", path.c_str()))
+				return false;
+
+			source.insert(version_end + 1, defines);
+			return true;
+		}
+
+
+		std::vector<std::string> getShaderSearchPaths(const std::string& path, RenderService& renderService, RenderAdvancedService& renderAdvancedService)
+		{
+			std::vector<std::string> search_paths = { utility::getFileDir(path) };
+			for (const auto* service_module : { &renderService.getModule(), &renderAdvancedService.getModule() })
+			{
+				const auto& module_paths = service_module->getInformation().mDataSearchPaths;
+				search_paths.insert(search_paths.end(), module_paths.begin(), module_paths.end());
+			}
+			return search_paths;
+		}
+	}
+}
@@ -0,0 +1,40 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// External Includes
+#include <utility/errorstate.h>
+#include <string>
+#include <vector>
+
+namespace nap
+{
+	// Forward Declares
+	class RenderService;
+	class RenderAdvancedService;
+
+	namespace utility
+	{
+		/**
+		 * Inserts defines into shader source, after the version directive which must come first
+		 * @param source the shader source
+		 * @param path the shader file, used for error reporting
+		 * @param defines one or more define directives, each terminated by a new line
+		 * @param errorState contains the error if the source has no version directive
+		 * @return if the defines are inserted
+		 */
+		NAPAPI bool insertShaderDefines(std::string& source, const std::string& path, const std::string& defines, utility::ErrorState& errorState);
+
+		/**
+		 * Returns the include search paths of a shader loaded from source:
+		 * the directory of the shader, followed by the data directories of the render modules.
+		 * @param path the shader file
+		 * @param renderService the render service
+		 * @param renderAdvancedService the render advanced service
+		 * @return the include search paths
+		 */
+		NAPAPI std::vector<std::string> getShaderSearchPaths(const std::string& path, RenderService& renderService, RenderAdvancedService& renderAdvancedService);
+	}
+}
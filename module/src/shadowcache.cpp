@@ -0,0 +1,112 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "shadowcache.h"
+
+// External Includes
+#include <renderablemeshcomponent.h>
+#include <transformcomponent.h>
+#include <cameracomponent.h>
+#include <entity.h>
+#include <algorithm>
+
+namespace nap
+{
+	static glm::mat4 getCasterTransform(TransformComponentInstance* transform)
+	{
+		return transform != nullptr ? transform->getGlobalTransform() : glm::identity<glm::mat4>();
+	}
+
+
+	static glm::mat4 getLightProjection(LightComponentInstance& light)
+	{
+		auto* camera = light.getShadowCamera();
+		return camera != nullptr ? camera->getProjectionMatrix() : glm::identity<glm::mat4>();
+	}
+
+
+	bool ShadowCache::update(const std::vector<RenderableComponentInstance*>& casters, const std::vector<LightComponentInstance*>& lights)
+	{
+		// Rebuild when the set of casters or lights changed
+		bool changed = !mValid;
+		bool same_casters = casters.size() == mCasters.size() && std::equal(casters.begin(), casters.end(), mCasters.begin(),
+			[](const auto* caster, const auto& state) { return caster == state.mComponent; });
+		bool same_lights = lights.size() == mLights.size() && std::equal(lights.begin(), lights.end(), mLights.begin(),
+			[](const auto* light, const auto& state) { return light == state.mComponent; });
+
+		if (!same_casters || !same_lights)
+		{
+			rebuild(casters, lights);
+			changed = true;
+		}
+
+		// Lights
+		for (auto& state : mLights)
+		{
+			auto& light = *state.mComponent;
+			glm::mat4 transform = light.getTransform().getGlobalTransform();
+			glm::mat4 projection = getLightProjection(light);
+			bool enabled = light.isEnabled() && light.isShadowEnabled();
+
+			changed |= transform != state.mTransform || projection != state.mProjection || enabled != state.mEnabled;
+			state.mTransform = transform;
+			state.mProjection = projection;
+			state.mEnabled = enabled;
+		}
+
+		// Casters
+		for (auto& state : mCasters)
+		{
+			glm::mat4 transform = getCasterTransform(state.mTransformComponent);
+			bool visible = state.mComponent->isVisible();
+			float alpha = state.mAlphaUniform != nullptr ? state.mAlphaUniform->getValue() : 1.0f;
+
+			changed |= transform != state.mTransform || visible != state.mVisible || alpha != state.mAlpha || (visible && state.mDynamic);
+			state.mTransform = transform;
+			state.mVisible = visible;
+			state.mAlpha = alpha;
+		}
+
+		mValid = true;
+		if (changed)
+			mRenderedCount++;
+		else
+			mSkippedCount++;
+		return changed;
+	}
+
+
+	void ShadowCache::rebuild(const std::vector<RenderableComponentInstance*>& casters, const std::vector<LightComponentInstance*>& lights)
+	{
+		mCasters.clear();
+		mCasters.reserve(casters.size());
+		for (auto* caster : casters)
+		{
+			CasterState state;
+			state.mComponent = caster;
+			state.mTransformComponent = caster->getEntityInstance()->findComponent<TransformComponentInstance>();
+			state.mDynamic = std::any_of(mDynamicTypes.begin(), mDynamicTypes.end(), [caster](const auto& type)
+			{
+				return caster->get_type().is_derived_from(type);
+			});
+
+			if (caster->get_type().is_derived_from(RTTI_OF(RenderableMeshComponentInstance)))
+			{
+				auto* ubo = static_cast<RenderableMeshComponentInstance*>(caster)->getMaterialInstance().findUniform("UBO");
+				state.mAlphaUniform = ubo != nullptr ? ubo->findUniform<UniformFloatInstance>("alpha") : nullptr;
+			}
+			mCasters.emplace_back(state);
+		}
+
+		mLights.clear();
+		mLights.reserve(lights.size());
+		for (auto* light : lights)
+		{
+			LightState state;
+			state.mComponent = light;
+			mLights.emplace_back(state);
+		}
+	}
+}
@@ -0,0 +1,92 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// External Includes
+#include <rendercomponent.h>
+#include <lightcomponent.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace nap
+{
+	// Forward declares
+	class UniformFloatInstance;
+	class TransformComponentInstance;
+
+	/**
+	 * Tracks the state of shadow casters and lights to decide if the shadow maps must be rendered again.
+	 *
+	 * The shadow maps are valid until a light or caster changes. A light changes when its global transform, shadow camera
+	 * projection or enabled state changes. A caster changes when its global transform, visibility or material alpha changes.
+	 * Hidden casters are tracked as well: components that draw them on their behalf, such as a poster batch, move with them.
+	 *
+	 * Casters that animate their geometry on the GPU can't be tracked, register their type using addDynamicType()
+	 * to render the shadow maps every frame they are visible.
+	 *
+	 * nap::RenderAdvancedService renders the shadow maps of all lights at once, the maps are therefore invalidated together.
+	 */
+	class NAPAPI ShadowCache final
+	{
+	public:
+		/**
+		 * Renders the shadow maps every frame a visible caster of the given type is present
+		 * @param type renderable component instance type
+		 */
+		void addDynamicType(const rtti::TypeInfo& type)		{ mDynamicTypes.emplace_back(type); }
+
+		/**
+		 * Forces the shadow maps to be rendered on the next update
+		 */
+		void invalidate()									{ mValid = false; }
+
+		/**
+		 * Compares the casters and lights with their state of the previous call
+		 * @param casters the shadow casters
+		 * @param lights the lights that cast shadows
+		 * @return if the shadow maps must be rendered
+		 */
+		bool update(const std::vector<RenderableComponentInstance*>& casters, const std::vector<LightComponentInstance*>& lights);
+
+		/**
+		 * @return number of updates that required the shadow maps to be rendered
+		 */
+		int getRenderedCount() const						{ return mRenderedCount; }
+
+		/**
+		 * @return number of updates that reused the shadow maps
+		 */
+		int getSkippedCount() const							{ return mSkippedCount; }
+
+	private:
+		struct CasterState
+		{
+			RenderableComponentInstance* mComponent = nullptr;
+			TransformComponentInstance* mTransformComponent = nullptr;
+			glm::mat4 mTransform;
+			float mAlpha = 1.0f;
+			bool mVisible = false;
+			bool mDynamic = false;
+			UniformFloatInstance* mAlphaUniform = nullptr;
+		};
+
+		struct LightState
+		{
+			LightComponentInstance* mComponent = nullptr;
+			glm::mat4 mTransform;
+			glm::mat4 mProjection;
+			bool mEnabled = false;
+		};
+
+		void rebuild(const std::vector<RenderableComponentInstance*>& casters, const std::vector<LightComponentInstance*>& lights);
+
+		std::vector<CasterState> mCasters;
+		std::vector<LightState> mLights;
+		std::vector<rtti::TypeInfo> mDynamicTypes;
+		bool mValid = false;
+		int mRenderedCount = 0;
+		int mSkippedCount = 0;
+	};
+}
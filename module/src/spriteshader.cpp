@@ -0,0 +1,147 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local includes
+#include "spriteshader.h"
+#include "shaderutils.h"
+
+// External includes
+#include <nap/core.h>
+#include <renderservice.h>
+#include <renderadvancedservice.h>
+#include <glm/glm.hpp>
+
+// nap::SpriteShader run time class definition 
+RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::SpriteShader)
+	RTTI_CONSTRUCTOR(nap::Core&)
+	RTTI_PROPERTY_FILELINK("VertShader",	&nap::SpriteShader::mVertPath,	nap::rtti::EPropertyMetaData::Required, nap::rtti::EPropertyFileType::VertShader)
+	RTTI_PROPERTY_FILELINK("FragShader",	&nap::SpriteShader::mFragPath,	nap::rtti::EPropertyMetaData::Required, nap::rtti::EPropertyFileType::FragShader)
+	RTTI_PROPERTY("Mesh",					&nap::SpriteShader::mMesh,		nap::rtti::EPropertyMetaData::Required)
+RTTI_END_CLASS
+
+// nap::SpriteComputeShader run time class definition 
+RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::SpriteComputeShader)
+	RTTI_CONSTRUCTOR(nap::Core&)
+	RTTI_PROPERTY_FILELINK("ComputeShader",	&nap::SpriteComputeShader::mComputePath,	nap::rtti::EPropertyMetaData::Required, nap::rtti::EPropertyFileType::ComputeShader)
+	RTTI_PROPERTY("Mesh",					&nap::SpriteComputeShader::mMesh,			nap::rtti::EPropertyMetaData::Required)
+	RTTI_PROPERTY("Noise",					&nap::SpriteComputeShader::mNoise,			nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("Packed",					&nap::SpriteComputeShader::mPacked,			nap::rtti::EPropertyMetaData::Default)
+RTTI_END_CLASS
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace nap
+{
+	/**
+	 * Verifies that every array of 'count' sprites fits in a single storage buffer range
+	 */
+	static bool validateCount(RenderService& renderService, const std::string& id, uint count, utility::ErrorState& errorState)
+	{
+		if (!errorState.check(count > 0, "%s: invalid sprite count", id.c_str()))
+			return false;
+
+		// The largest buffers hold 16 bytes per sprite: the state and unpacked particles
+		const uint64 size = static_cast<uint64>(count) * sizeof(glm::vec4);
+		const uint64 max_size = renderService.getPhysicalDeviceProperties().limits.maxStorageBufferRange;
+		return errorState.check(size <= max_size, "%s: %d sprites exceed the maximum storage buffer range of %llu bytes",
+			id.c_str(), count, static_cast<unsigned long long>(max_size));
+	}
+
+
+	/**
+	 * Defines 'MAX_SPRITES'
+	 */
+	static std::string defineCount(uint count)
+	{
+		return utility::stringFormat("#define MAX_SPRITES %d\n", count);
+	}
+
+
+	/**
+	 * Defines 'BAKED_NOISE' and the layout of the noise texture, see noisetexture.glslinc
+	 */
+	static std::string defineNoise(const NoiseTexture& noise)
+	{
+		return utility::stringFormat("#define BAKED_NOISE\n#define NOISE_RESOLUTION %d\n#define NOISE_PERIOD %d\n#define NOISE_COLUMNS %d\n",
+			noise.mResolution, noise.mPeriod, noise.getColumns());
+	}
+
+
+	//////////////////////////////////////////////////////////////////////////
+	// SpriteShader
+	//////////////////////////////////////////////////////////////////////////
+
+	SpriteShader::SpriteShader(Core& core) :
+		Shader(core),
+		mRenderService(core.getService<RenderService>()),
+		mRenderAdvancedService(core.getService<RenderAdvancedService>())
+	{ }
+
+
+	bool SpriteShader::init(utility::ErrorState& errorState)
+	{
+		if (!Shader::init(errorState))
+			return false;
+
+		if (!validateCount(*mRenderService, mID, mMesh->getCount(), errorState))
+			return false;
+
+		// Read vert shader file
+		std::string vert_source;
+		if (!errorState.check(utility::readFileToString(mVertPath, vert_source, errorState), "Unable to read shader file %s", mVertPath.c_str()))
+			return false;
+
+		// Read frag shader file
+		std::string frag_source;
+		if (!errorState.check(utility::readFileToString(mFragPath, frag_source, errorState), "Unable to read shader file %s", mFragPath.c_str()))
+			return false;
+
+		if (!utility::insertShaderDefines(vert_source, mVertPath, defineCount(mMesh->getCount()), errorState))
+			return false;
+
+		// Parse shader
+		std::string shader_name = utility::getFileNameWithoutExtension(mVertPath);
+		return load(shader_name, utility::getShaderSearchPaths(mVertPath, *mRenderService, *mRenderAdvancedService), vert_source.data(), vert_source.size(), frag_source.data(), frag_source.size(), errorState);
+	}
+
+
+	//////////////////////////////////////////////////////////////////////////
+	// SpriteComputeShader
+	//////////////////////////////////////////////////////////////////////////
+
+	SpriteComputeShader::SpriteComputeShader(Core& core) :
+		ComputeShader(core),
+		mRenderService(core.getService<RenderService>()),
+		mRenderAdvancedService(core.getService<RenderAdvancedService>())
+	{ }
+
+
+	bool SpriteComputeShader::init(utility::ErrorState& errorState)
+	{
+		if (!ComputeShader::init(errorState))
+			return false;
+
+		if (!validateCount(*mRenderService, mID, mMesh->getCount(), errorState))
+			return false;
+
+		// Read compute shader file
+		std::string comp_source;
+		if (!errorState.check(utility::readFileToString(mComputePath, comp_source, errorState), "Unable to read shader file %s", mComputePath.c_str()))
+			return false;
+
+		std::string defines = defineCount(mMesh->getCount());
+		if (mNoise != nullptr)
+			defines += defineNoise(*mNoise);
+
+		if (mPacked)
+			defines += "#define PACKED_PARTICLES\n";
+
+		if (!utility::insertShaderDefines(comp_source, mComputePath, defines, errorState))
+			return false;
+
+		// Parse shader
+		std::string shader_name = utility::getFileNameWithoutExtension(mComputePath);
+		return load(shader_name, utility::getShaderSearchPaths(mComputePath, *mRenderService, *mRenderAdvancedService), comp_source.data(), comp_source.size(), errorState);
+	}
+}
@@ -0,0 +1,94 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// Local Includes
+#include "noisetexture.h"
+#include "particlemesh.h"
+
+// External Includes
+#include <shader.h>
+#include <computeshader.h>
+
+namespace nap
+{
+	// Forward declares
+	class Core;
+	class RenderService;
+	class RenderAdvancedService;
+
+	/**
+	 * Point sprite shader with storage buffers that hold one element per sprite.
+	 *
+	 * NAP validates a buffer binding against the size of the array declared in the shader, storage buffers with
+	 * unsized arrays can't be bound. This shader sizes the arrays on load instead: 'MAX_SPRITES' is defined as
+	 * the count of the 'Mesh' in the vertex shader, the bound buffers must therefore be sized for the same mesh.
+	 *
+	 * ~~~~~{.vert}
+	 *		layout(std430) readonly buffer SpriteBuffer
+	 *		{
+	 *			uint sprites[MAX_SPRITES * 4];
+	 *		};
+	 * ~~~~
+	 */
+	class NAPAPI SpriteShader : public Shader
+	{
+		RTTI_ENABLE(Shader)
+	public:
+		// Constructor
+		SpriteShader(Core& core);
+
+		/**
+		 * Loads the shaders, defines 'MAX_SPRITES' and compiles them.
+		 * @param errorState contains the error if initialization fails.
+		 * @return if initialization succeeded.
+		 */
+		virtual bool init(utility::ErrorState& errorState) override;
+
+		std::string	mVertPath;						///< Property: 'VertShader' path to the vertex shader on disk
+		std::string	mFragPath;						///< Property: 'FragShader' path to the fragment shader on disk
+		ResourcePtr<ParticleMesh> mMesh;			///< Property: 'Mesh' the sprites that are drawn, its count defines 'MAX_SPRITES'
+
+	private:
+		RenderService* mRenderService = nullptr;
+		RenderAdvancedService* mRenderAdvancedService = nullptr;
+	};
+
+
+	/**
+	 * Compute shader that simulates the point sprites, see nap::SpriteShader.
+	 * 'MAX_SPRITES' is defined as the count of the 'Mesh', the bound particle buffers must be sized for the same mesh.
+	 *
+	 * 'BAKED_NOISE' is defined when a 'Noise' texture is given, together with the layout of the texture.
+	 * The shader then samples the baked volume instead of evaluating the noise, bind the texture as 'noiseTexture'.
+	 *
+	 * 'PACKED_PARTICLES' is defined when 'Packed' is enabled. The shader then reads the particle positions as four half floats
+	 * and the hashes as RGBA8 unorm, 12 instead of 32 bytes per particle. Bind nap::GPUBufferUInt buffers, filled using a
+	 * nap::PackedHalfFillPolicy and nap::PackedUnormFillPolicy.
+	 */
+	class NAPAPI SpriteComputeShader : public ComputeShader
+	{
+		RTTI_ENABLE(ComputeShader)
+	public:
+		// Constructor
+		SpriteComputeShader(Core& core);
+
+		/**
+		 * Loads the shader, defines 'MAX_SPRITES', 'BAKED_NOISE' and 'PACKED_PARTICLES' when applicable and compiles it.
+		 * @param errorState contains the error if initialization fails.
+		 * @return if initialization succeeded.
+		 */
+		virtual bool init(utility::ErrorState& errorState) override;
+
+		std::string	mComputePath;					///< Property: 'ComputeShader' path to the compute shader on disk
+		ResourcePtr<ParticleMesh> mMesh;			///< Property: 'Mesh' the sprites that are simulated, its count defines 'MAX_SPRITES'
+		ResourcePtr<NoiseTexture> mNoise;			///< Property: 'Noise' optional baked noise, defines 'BAKED_NOISE'
+		bool		mPacked = false;				///< Property: 'Packed' if the particle buffers are packed, defines 'PACKED_PARTICLES'
+
+	private:
+		RenderService* mRenderService = nullptr;
+		RenderAdvancedService* mRenderAdvancedService = nullptr;
+	};
+}
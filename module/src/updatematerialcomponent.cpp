@@ -1,7 +1,9 @@
 #include "updatematerialcomponent.h"
+#include "lovepostersservice.h"
 
 // External Includes
 #include <entity.h>
+#include <nap/core.h>
 #include <renderablemeshcomponent.h>
 #include <blinnphongcolorshader.h>
 
@@ -35,6 +37,8 @@ namespace nap
 
 	bool UpdateMaterialComponentInstance::init(utility::ErrorState& errorState)
 	{
+		mService = getEntityInstance()->getCore()->getService<LovePostersService>();
+
 		mResource = getComponent<UpdateMaterialComponent>();
 		mRenderableMeshComponent = &getEntityInstance()->getComponent<RenderableMeshComponentInstance>();
 
@@ -110,6 +114,9 @@ namespace nap
 
 	void UpdateMaterialComponentInstance::update(double deltaTime)
 	{
+		ProfileScope profile_scope(mService->getUpdateMarker(*this));
+		deltaTime = mService->getTimeStep(deltaTime);
+
 		mElapsedTime += static_cast<float>(deltaTime);
 		auto* elapsed_time_uni = mUniformStruct->getOrCreateUniform<UniformFloatInstance>("elapsedTime");
 		if (elapsed_time_uni != nullptr)
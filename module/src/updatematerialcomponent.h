@@ -7,8 +7,12 @@
 #include <parametercolor.h>
 #include <uniforminstance.h>
 
+
 namespace nap
 {
+	// Forward declares
+	class LovePostersService;
+
 	class UpdateMaterialComponentInstance;
 	class RenderableMeshComponentInstance;
 	class UniformStructInstance;
@@ -65,6 +69,7 @@ namespace nap
 
 	private:
 		UpdateMaterialComponent* mResource = nullptr;
+		LovePostersService* mService = nullptr;		///< Provides the time step
 		RenderableMeshComponentInstance* mRenderableMeshComponent = nullptr;
 
 		UniformStructInstance* mUniformStruct = nullptr;
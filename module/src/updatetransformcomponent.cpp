@@ -1,7 +1,9 @@
 #include "updatetransformcomponent.h"
+#include "lovepostersservice.h"
 
 // External Includes
 #include <entity.h>
+#include <nap/core.h>
 #include <glm/gtc/noise.hpp>
 
 // nap::UpdateTransformComponent run time class definition 
@@ -30,6 +32,7 @@ namespace nap
 
 	bool UpdateTransformComponentInstance::init(utility::ErrorState& errorState)
 	{
+		mService = getEntityInstance()->getCore()->getService<LovePostersService>();
 		mResource = getComponent<UpdateTransformComponent>();
 		mTransformComponent = &getEntityInstance()->getComponent<TransformComponentInstance>();
 		return true;
@@ -38,6 +41,8 @@ namespace nap
 
 	void UpdateTransformComponentInstance::update(double deltaTime)
 	{
+		ProfileScope profile_scope(mService->getUpdateMarker(*this));
+
 		if (mResource->mEnable)
 		{
 			if (mResource->mAngle != nullptr)
@@ -12,6 +12,7 @@
 namespace nap
 {
 	class UpdateTransformComponentInstance;
+	class LovePostersService;
 
 	/**
 	 * UpdateTransformComponent
@@ -56,6 +57,7 @@ namespace nap
 
 	private:
 		UpdateTransformComponent* mResource = nullptr;
+		LovePostersService* mService = nullptr;		///< Measures the update
 		TransformComponentInstance* mTransformComponent = nullptr;
 
 		std::unique_ptr<AffineTransform> mCachedTransform;
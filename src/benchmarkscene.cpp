@@ -0,0 +1,133 @@
+// Local Includes
+#include "benchmarkscene.h"
+
+// External Includes
+#include <utility/fileutils.h>
+#include <rapidjson/document.h>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+
+namespace nap
+{
+	namespace benchmarkscene
+	{
+		using JSONVisitor = std::function<void(rapidjson::Value&)>;
+
+		/**
+		 * Calls the visitor for every object in the document, depth first, including objects nested in entities and groups
+		 */
+		static void visitObjects(rapidjson::Value& value, const JSONVisitor& visitor)
+		{
+			if (value.IsArray())
+			{
+				for (auto& element : value.GetArray())
+					visitObjects(element, visitor);
+			}
+			else if (value.IsObject())
+			{
+				visitor(value);
+				for (auto& member : value.GetObject())
+					visitObjects(member.value, visitor);
+			}
+		}
+
+
+		/**
+		 * Removes all render windows from the arrays in the document, recursively
+		 */
+		static void removeWindows(rapidjson::Value& value)
+		{
+			if (value.IsArray())
+			{
+				for (auto it = value.Begin(); it != value.End();)
+				{
+					if (it->IsObject() && it->HasMember("Type") && (*it)["Type"] == "nap::RenderWindow")
+					{
+						it = value.Erase(it);
+						continue;
+					}
+					removeWindows(*it);
+					++it;
+				}
+			}
+			else if (value.IsObject())
+			{
+				for (auto& member : value.GetObject())
+					removeWindows(member.value);
+			}
+		}
+
+
+		/**
+		 * @return the string property of the first object that matches, empty when not found
+		 */
+		static std::string findProperty(rapidjson::Value& document, const char* key, const char* match, const char* property)
+		{
+			std::string result;
+			visitObjects(document, [&](rapidjson::Value& object)
+			{
+				if (result.empty() && object.HasMember(key) && object[key] == match && object.HasMember(property) && object[property].IsString())
+					result = object[property].GetString();
+			});
+			return result;
+		}
+
+
+		bool write(const std::string& sourceFile, const std::string& targetFile, const std::string& captureSource, utility::ErrorState& errorState)
+		{
+			std::string json;
+			if (!utility::readFileToString(sourceFile, json, errorState))
+				return false;
+
+			rapidjson::Document document;
+			document.Parse(json.c_str());
+			if (!errorState.check(!document.HasParseError() && document.IsObject(), "Unable to parse scene: %s", sourceFile.c_str()))
+				return false;
+
+			removeWindows(document);
+
+			// Allow the capture texture to be downloaded
+			if (!captureSource.empty())
+			{
+				std::string texture_id = captureSource;
+				if (captureSource == "color")
+					texture_id = findProperty(document, "mID", "ColorTarget", "ColorTexture");
+				else if (captureSource == "bloom")
+					texture_id = findProperty(document, "Type", "nap::RenderBloomComponent", "OutputTexture");
+
+				bool found = false;
+				visitObjects(document, [&](rapidjson::Value& object)
+				{
+					if (found || !object.HasMember("mID") || object["mID"] != texture_id.c_str())
+						return;
+
+					found = true;
+					if (object.HasMember("Usage"))
+						object["Usage"].SetString("DynamicRead");
+					else
+						object.AddMember("Usage", "DynamicRead", document.GetAllocator());
+				});
+
+				if (!errorState.check(found, "Unable to find capture texture '%s' in scene: %s", captureSource.c_str(), sourceFile.c_str()))
+					return false;
+			}
+
+			// Write the copy
+			std::error_code error;
+			std::filesystem::create_directories(std::filesystem::path(targetFile).parent_path(), error);
+			if (!errorState.check(!error, "Unable to create directory for %s: %s", targetFile.c_str(), error.message().c_str()))
+				return false;
+
+			rapidjson::StringBuffer buffer;
+			rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+			document.Accept(writer);
+
+			std::ofstream stream(targetFile, std::ios::out | std::ios::trunc);
+			stream << buffer.GetString();
+			return errorState.check(stream.good(), "Unable to write scene: %s", targetFile.c_str());
+		}
+	}
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+// External Includes
+#include <utility/errorstate.h>
+#include <string>
+
+namespace nap
+{
+	namespace benchmarkscene
+	{
+		/**
+		 * Writes a copy of a scene file that can be rendered headless, for benchmarking.
+		 *
+		 * All nap::RenderWindow objects are removed, the benchmark never creates a window and only records headless passes.
+		 * The texture to capture is changed to 'DynamicRead' usage, textures can only be downloaded with that usage.
+		 * The capture source is 'color' for the color texture of the 'ColorTarget', 'bloom' for the output texture of the
+		 * bloom component or the ID of a texture. Nothing is changed when the capture source is empty.
+		 *
+		 * Relative paths in the scene are resolved against the data directory, not the location of the file,
+		 * the copy can therefore be written anywhere.
+		 *
+		 * @param sourceFile the scene to copy
+		 * @param targetFile the headless copy, the directory is created when it doesn't exist
+		 * @param captureSource the texture to capture, optional
+		 * @param errorState contains the error if the scene can't be read, converted or written
+		 * @return if the copy was written
+		 */
+		bool write(const std::string& sourceFile, const std::string& targetFile, const std::string& captureSource, utility::ErrorState& errorState);
+	}
+}
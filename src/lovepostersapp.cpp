@@ -7,17 +7,97 @@
 #include <inputrouter.h>
 #include <perspcameracomponent.h>
 #include <rendertotexturecomponent.h>
+#include <renderablemeshcomponent.h>
 #include <renderbloomcomponent.h>
 #include <renderdofcomponent.h>
 #include <rendermultivideocomponent.h>
 #include <funtransformcomponent.h>
+#include <pointspritevolume.h>
 #include <orthocameracomponent.h>
 #include <audio/component/playbackcomponent.h>
 #include <depthsorter.h>
 #include <sdlhelpers.h>
+#include <bitmap.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include <nap/logger.h>
+#include <lovepostersservice.h>
 
 namespace nap 
 {    
+	namespace graph
+	{
+		inline constexpr const char* shadowMaps = "ShadowMaps";	///< Virtual resource, shadow maps are managed by the render advanced service
+	}
+
+	/**
+	 * Appends the textures bound to the samplers of the given material that are used by the render passes of this app.
+	 */
+	static void getSampledTextures(MaterialInstance& material, std::vector<const Texture2D*>& outTextures)
+	{
+		for (const auto* name : { "colorTexture", "colorTextures", "stencilTexture" })
+		{
+			auto* sampler = material.findSampler(name);
+			if (sampler == nullptr)
+				continue;
+
+			if (sampler->get_type().is_derived_from(RTTI_OF(Sampler2DArrayInstance)))
+			{
+				auto* sampler_array = static_cast<Sampler2DArrayInstance*>(sampler);
+				for (int i = 0; i < sampler_array->getNumElements(); i++)
+					outTextures.emplace_back(&sampler_array->getTexture(i));
+			}
+			else if (sampler->get_type().is_derived_from(RTTI_OF(Sampler2DInstance)))
+			{
+				auto* sampler_2d = static_cast<Sampler2DInstance*>(sampler);
+				if (sampler_2d->hasTexture())
+					outTextures.emplace_back(&sampler_2d->getTexture());
+			}
+		}
+	}
+
+
+	/**
+	 * Maps every texture to the frame graph resource that holds its latest content.
+	 * Resources are named after the pass output they hold, multiple resources can therefore share the same texture.
+	 */
+	using TextureResources = std::unordered_map<const Texture2D*, std::string>;
+
+
+	/**
+	 * Registers the output of a pass, subsequently declared readers of the texture read this resource.
+	 */
+	static std::string writeResource(FrameGraph& graph, TextureResources& resources, const std::string& name, const Texture2D& texture)
+	{
+		graph.addResource(name, &texture);
+		resources[&texture] = name;
+		return name;
+	}
+
+
+	/**
+	 * Returns the names of the resources that hold the latest content of the given textures.
+	 * Textures that are not written by a declared pass are imported under their ID.
+	 */
+	static std::vector<std::string> readResources(FrameGraph& graph, TextureResources& resources, const std::vector<const Texture2D*>& textures)
+	{
+		std::vector<std::string> names;
+		for (const auto* texture : textures)
+		{
+			auto it = resources.find(texture);
+			if (it == resources.end())
+			{
+				graph.addResource(texture->mID, texture);
+				it = resources.emplace(texture, texture->mID).first;
+			}
+			names.emplace_back(it->second);
+		}
+		return names;
+	}
+
+
     bool LovePostersApp::init(utility::ErrorState& error)
     {
 		// Retrieve services
@@ -26,13 +106,14 @@ namespace nap
 		mSceneService			= getCore().getService<nap::SceneService>();
 		mInputService			= getCore().getService<nap::InputService>();
 		mGuiService				= getCore().getService<nap::IMGuiService>();
+		mProfiler				= &getCore().getService<nap::LovePostersService>()->getProfiler();
 
 		// Fetch the resource manager
         mResourceManager 		= getCore().getResourceManager();
 
-		// Get the render window
+		// Get the render window, the benchmark scene has none
 		mRenderWindow = mResourceManager->findObject<nap::RenderWindow>("Window");
-		if (!error.check(mRenderWindow != nullptr, "unable to find nap::RenderWindow with name: %s", "Window"))
+		if (!error.check(mRenderWindow != nullptr || mBenchmark.mEnabled, "unable to find nap::RenderWindow with name: %s", "Window"))
 			return false;
 
 		mColorTarget = mResourceManager->findObject<RenderTarget>("ColorTarget");
@@ -56,6 +137,45 @@ namespace nap
 		mRenderCameraEntity 	= mScene->findEntity("RenderCameraEntity");
 		mWarpEntity 			= mScene->findEntity("WarpEntity");
 
+		// Render masks
+		mShadowMask = mRenderService->getRenderMask("Shadow");
+		mStencilMask = mRenderService->getRenderMask("Stencil");
+		mDefaultMask = mRenderService->getRenderMask("Default");
+		if (mDefaultMask == 0)
+			mDefaultMask = mask::all;
+
+		// Cache renderable components, rebuilt when resources are reloaded
+		mWorldRegistry.setRoot(mWorldEntity.get());
+		mWarpRegistry.setRoot(mWarpEntity.get());
+		mResourceManager->mPostResourcesLoadedSignal.connect(mResourcesLoadedSlot);
+
+		// Shadows are only rendered when lights or casters change, point sprites are animated on the GPU.
+		// Scenes tag their sprite volumes 'NoShadow' to keep them out of the shadow pass and the cache valid.
+		mScene->getRootEntity().getComponentsOfTypeRecursive<LightComponentInstance>(mLights);
+		mScene->getRootEntity().getComponentsOfTypeRecursive<PointSpriteVolumeInstance>(mSpriteVolumes);
+		mShadowCache.addDynamicType(RTTI_OF(PointSpriteVolumeInstance));
+
+		// Profile markers
+		mUpdateMarker = mProfiler->registerMarker("update", Profiler::EDomain::CPU);
+		mRenderMarker = mProfiler->registerMarker("render", Profiler::EDomain::CPU);
+		mWindowMarker = mProfiler->registerMarker("Window", Profiler::EDomain::GPU);
+		mBeginPass = [this](const FrameGraph::Pass& pass)
+		{
+			auto it = mPassMarkers.find(&pass);
+			if (it != mPassMarkers.end())
+				mProfiler->beginGPU(it->second, mRenderService->getCurrentCommandBuffer());
+		};
+		mEndPass = [this](const FrameGraph::Pass& pass)
+		{
+			auto it = mPassMarkers.find(&pass);
+			if (it != mPassMarkers.end())
+				mProfiler->endGPU(it->second, mRenderService->getCurrentCommandBuffer());
+		};
+
+		// Declare the headless render passes
+		if (!initFrameGraph(error))
+			return false;
+
 		// Start video players
 		auto video_players = mResourceManager->getObjects<VideoPlayer>();
 		for (auto& player : video_players)
@@ -64,8 +184,18 @@ namespace nap
 		mAppGUIs = mResourceManager->getObjects<AppGUI>();
 
 		setFramerate(60.0f);
-		capFramerate(true);
-		SDL::hideCursor();
+		capFramerate(!mBenchmark.mEnabled);
+
+		// Benchmark: advance with a fixed time step, never present
+		if (mBenchmark.mEnabled)
+		{
+			getCore().getService<LovePostersService>()->setFixedTimeStep(mBenchmark.mTimeStep);
+			nap::Logger::info("Benchmark: rendering %d frames with a time step of %.4fs", mBenchmark.mFrames, mBenchmark.mTimeStep);
+		}
+		else
+		{
+			SDL::hideCursor();
+		}
 
 		return true;
     }
@@ -74,44 +204,348 @@ namespace nap
     // Called when the window is going to render
     void LovePostersApp::render()
     {
+		// Create all pipelines up front, avoids hitches when hidden geometry is first shown
+		if (mPrewarmRequested)
+		{
+			prewarm();
+			if (mBenchmark.mEnabled && mBenchmarkFrame == 0)
+				mLastFrameTime = std::chrono::steady_clock::now();
+		}
+
+		// After the last benchmark frame only the frames in flight are processed, until the capture is downloaded
+		const bool record = !mBenchmark.mEnabled || mBenchmarkFrame < mBenchmark.mFrames;
+
 		// Signal the beginning of a new frame, allowing it to be recorded.
 		// The system might wait until all commands that were previously associated with the new frame have been processed on the GPU.
 		// Multiple frames are in flight at the same time, but if the graphics load is heavy the system might wait here to ensure resources are available.
 		mRenderService->beginFrame();
+		ProfileScope profile_scope(mRenderMarker);
+		mProfiler->beginFrame();
+
+		// Mix the video layers and simulate the point sprites using compute, recorded before and submitted ahead of all render commands
+		const bool compute_video = mMultiVideo != nullptr && mMultiVideo->getMode() == EVideoMode::Compute;
+		if (record && (compute_video || !mSpriteVolumes.empty()) && mRenderService->beginComputeRecording())
+		{
+			if (compute_video)
+				mMultiVideo->compute();
+
+			for (auto* volume : mSpriteVolumes)
+				volume->compute();
+
+			mRenderService->endComputeRecording();
+		}
 
 		// Begin recording the render commands for the offscreen render target. Rendering always happens after compute.
 		// This prepares a command buffer and starts a render pass.
-		if (mRenderService->beginHeadlessRecording())
+		if (record && mRenderService->beginHeadlessRecording())
 		{
-			// The world entity holds all visible renderable components in the scene.
-			std::vector<RenderableComponentInstance*> render_comps;
-			mWorldEntity->getComponentsOfTypeRecursive<RenderableComponentInstance>(render_comps);
+			// Reset the timestamp queries of this frame, outside of a render pass
+			mProfiler->resetQueries(mRenderService->getCurrentCommandBuffer());
+
+			// Record all passes that contribute to the final image, in dependency order
+			mFrameGraph.execute(mBeginPass, mEndPass);
+
+			// End headless recording
+			mRenderService->endHeadlessRecording();
+		}
+
+		// Begin recording the render commands for the main render window, skipped when benchmarking
+		if (!mBenchmark.mEnabled && mRenderService->beginRecording(*mRenderWindow))
+		{
+			// Begin render pass
+			mProfiler->beginGPU(mWindowMarker, mRenderService->getCurrentCommandBuffer());
+			mRenderWindow->beginRendering();
 
 			// Get Perspective camera to render with
-			auto& cam = mCameraEntity->getComponent<CameraComponentInstance>();
+			auto& cam = mRenderCameraEntity->getComponent<CameraComponentInstance>();
+
+			// Get composite component responsible for rendering final texture
+			if (mCompositeComp != nullptr)
+			{
+				// Render composite component
+				// The nap::RenderToTextureComponentInstance transforms a plane to match the window dimensions and applies the texture to it.
+				mRenderService->renderObjects(*mRenderWindow, cam, { mCompositeComp });
+			}
+			else if (mWarpEntity != nullptr)
+			{
+				// Render warp components
+				mRenderService->renderObjects(*mRenderWindow, cam, mWarpRegistry.getRenderables());
+			}
+
+			// Draw GUI elements
+			mGuiService->draw();
+
+			// Stop render pass
+			mRenderWindow->endRendering();
+			mProfiler->endGPU(mWindowMarker, mRenderService->getCurrentCommandBuffer());
+
+			// End recording
+			mRenderService->endRecording();
+		}
+
+		// Count benchmark frames and request capture, the download is queued in the current frame
+		if (mBenchmark.mEnabled)
+			advanceBenchmark();
+
+		// Proceed to next frame
+		mRenderService->endFrame();
+    }
+
+
+	void LovePostersApp::prewarm()
+	{
+		mPrewarmRequested = false;
+		const auto start = std::chrono::steady_clock::now();
+
+		// Show all renderables, pipelines are created for the passes and masks they are drawn in
+		std::vector<RenderableComponentInstance*> hidden;
+		for (auto* registry : { &mWorldRegistry, &mWarpRegistry })
+		{
+			for (auto* renderable : registry->getRenderables())
+			{
+				if (!renderable->isVisible())
+				{
+					renderable->setVisible(true);
+					hidden.emplace_back(renderable);
+				}
+			}
+		}
+
+		// Record the frame graph, the result is never presented
+		mRenderService->beginFrame();
+		if (mRenderService->beginHeadlessRecording())
+		{
+			mFrameGraph.execute();
+			mRenderService->endHeadlessRecording();
+		}
+
+		// The warp meshes are drawn to the window, create their pipelines without recording
+		int warp_count = 0;
+		if (mRenderWindow != nullptr && mCompositeComp == nullptr)
+		{
+			for (auto* renderable : mWarpRegistry.getRenderables())
+			{
+				if (!renderable->get_type().is_derived_from(RTTI_OF(RenderableMeshComponentInstance)))
+					continue;
+
+				utility::ErrorState error;
+				auto* mesh_comp = static_cast<RenderableMeshComponentInstance*>(renderable);
+				if (mRenderService->getOrCreatePipeline(*mRenderWindow, mesh_comp->getMesh(), mesh_comp->getMaterialInstance(), error).mPipeline == VK_NULL_HANDLE)
+					nap::Logger::warn("Prewarm: unable to create pipeline for %s: %s", mesh_comp->mID.c_str(), error.toString().c_str());
+				warp_count++;
+			}
+		}
+		mRenderService->endFrame();
+
+		for (auto* renderable : hidden)
+			renderable->setVisible(false);
+
+		const float elapsed = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+		nap::Logger::info("Prewarmed %d passes, %d renderables (%d hidden) and %d warp meshes in %.2fms", static_cast<int>(mFrameGraph.getSchedule().size()),
+			static_cast<int>(mWorldRegistry.getRenderables().size()), static_cast<int>(hidden.size()), warp_count, elapsed);
+	}
+
+
+	void LovePostersApp::advanceBenchmark()
+	{
+		// Every recorded frame is measured, the first from the end of the prewarm
+		if (mBenchmarkFrame < mBenchmark.mFrames)
+		{
+			auto now = std::chrono::steady_clock::now();
+			mFrameTimes.emplace_back(std::chrono::duration<float, std::milli>(now - mLastFrameTime).count());
+			mLastFrameTime = now;
+
+			if (++mBenchmarkFrame == mBenchmark.mFrames)
+			{
+				reportBenchmark();
+				if (!mBenchmark.mCaptureFile.empty())
+					requestCapture();
+			}
+			if (mBenchmarkFrame < mBenchmark.mFrames)
+				return;
+		}
+		else
+		{
+			mFlushFrames++;
+		}
+
+		// Wait for the capture download to complete, it is available after all frames in flight are processed
+		if (!mCaptureRequested || mCaptureDone || mFlushFrames > mRenderService->getMaxFramesInFlight() + 1)
+		{
+			if (mCaptureRequested && !mCaptureDone)
+			{
+				nap::Logger::error("Benchmark: capture download did not complete");
+				mExitCode = -1;
+			}
+			quit();
+		}
+	}
+
+
+	void LovePostersApp::reportBenchmark()
+	{
+		std::vector<float> sorted = mFrameTimes;
+		std::sort(sorted.begin(), sorted.end());
+
+		auto percentile = [&sorted](float p)
+		{
+			int idx = static_cast<int>(std::ceil(p * static_cast<float>(sorted.size()))) - 1;
+			return sorted.empty() ? 0.0f : sorted[std::clamp<int>(idx, 0, sorted.size() - 1)];
+		};
+
+		float total = 0.0f;
+		for (float time : sorted)
+			total += time;
+		const float average = sorted.empty() ? 0.0f : total / static_cast<float>(sorted.size());
+
+		nap::Logger::info("Benchmark: %d frames in %.2fs", static_cast<int>(sorted.size()), total * 0.001f);
+		nap::Logger::info("Benchmark: frame avg %.3fms (%.1ffps) | p95 %.3fms | p99 %.3fms | max %.3fms",
+			average, average > 0.0f ? 1000.0f / average : 0.0f, percentile(0.95f), percentile(0.99f), sorted.empty() ? 0.0f : sorted.back());
+
+		nap::Logger::info("Benchmark: shadows rendered %d | reused %d", mShadowCache.getRenderedCount(), mShadowCache.getSkippedCount());
+		if (mMultiVideo != nullptr)
+			nap::Logger::info("Benchmark: video rendered %d | reused %d", mMultiVideo->getRenderedCount(), mMultiVideo->getSkippedCount());
+		for (const auto& entry : mProfiler->getStats())
+		{
+			nap::Logger::info("Benchmark: %s %s avg %.3fms | p95 %.3fms | p99 %.3fms", entry.mDomain == Profiler::EDomain::GPU ? "gpu" : "cpu",
+				entry.mName.c_str(), entry.mAverage, entry.mP95, entry.mP99);
+		}
+
+		if (!mBenchmark.mOutputFile.empty())
+		{
+			utility::ErrorState error;
+			if (!mProfiler->writeCSV(mBenchmark.mOutputFile, error))
+			{
+				nap::Logger::error(error.toString());
+				mExitCode = -1;
+			}
+		}
+	}
+
+
+	void LovePostersApp::requestCapture()
+	{
+		// Resolve the texture to capture
+		Texture2D* texture = nullptr;
+		if (mBenchmark.mCaptureSource == "color")
+		{
+			texture = &mColorTarget->getColorTexture();
+		}
+		else if (mBenchmark.mCaptureSource == "bloom")
+		{
+			auto* bloom = mRenderEntity != nullptr ? mRenderEntity->findComponent<RenderBloomComponentInstance>() : nullptr;
+			if (bloom != nullptr)
+				texture = bloom->getComponent<RenderBloomComponent>()->mOutputTexture.get();
+		}
+		else
+		{
+			texture = mResourceManager->findObject<Texture2D>(mBenchmark.mCaptureSource).get();
+		}
+
+		if (texture == nullptr)
+		{
+			nap::Logger::error("Benchmark: unable to find capture texture: %s", mBenchmark.mCaptureSource.c_str());
+			mExitCode = -1;
+			return;
+		}
+
+		// Only textures with 'DynamicRead' usage can be downloaded, set by the benchmark scene
+		if (texture->mUsage != Texture2D::EUsage::DynamicRead)
+		{
+			nap::Logger::error("Benchmark: capture texture %s does not have 'DynamicRead' usage", texture->mID.c_str());
+			mExitCode = -1;
+			return;
+		}
+
+		// Write the downloaded data to disk
+		mCaptureRequested = true;
+		SurfaceDescriptor descriptor = texture->getDescriptor();
+		texture->asyncGetData([this, descriptor](const void* data, size_t size)
+		{
+			utility::ErrorState error;
+			Bitmap bitmap(getCore());
+			if (bitmap.initFromDescriptor(descriptor, error))
+			{
+				std::memcpy(bitmap.getData(), data, std::min<size_t>(size, bitmap.getSizeInBytes()));
+				if (bitmap.writeToDisk(mBenchmark.mCaptureFile, error))
+					nap::Logger::info("Benchmark: captured %s to %s", mBenchmark.mCaptureSource.c_str(), mBenchmark.mCaptureFile.c_str());
+			}
+
+			if (error.hasErrors())
+			{
+				nap::Logger::error("Benchmark: unable to write capture: %s", error.toString().c_str());
+				mExitCode = -1;
+			}
+			mCaptureDone = true;
+		});
+	}
 
-			// Render shadows
-			const auto shadow_mask = mRenderService->getRenderMask("Shadow");
-			mRenderAdvancedService->renderShadows(render_comps, true, shadow_mask);
 
-			// Video
-			auto* multi_video = mRenderEntity->findComponent<RenderMultiVideoComponentInstance>();
-			if (multi_video != nullptr)
+    bool LovePostersApp::initFrameGraph(utility::ErrorState& error)
+    {
+		mFrameGraph.clear();
+		TextureResources resources;
+
+		// Render shadows
+		mFrameGraph.addResource(graph::shadowMaps, nullptr);
+		mFrameGraph.addPass("Shadows", {}, { graph::shadowMaps }, [this]()
+		{
+			// Shadow maps keep their content, only push light changes when lights and casters are unchanged
+			const auto& casters = mWorldRegistry.getRenderables(mShadowMask);
+			if (mShadowCache.update(casters, mLights))
+			{
+				mRenderAdvancedService->renderShadows(casters, true, mShadowMask);
+				return;
+			}
+
+			utility::ErrorState error;
+			if (!mRenderAdvancedService->pushLights(casters, error))
+				nap::Logger::error("Unable to push lights: %s", error.toString().c_str());
+		});
+
+		// Video, converted and copied into the output texture in the compute recording in compute mode
+		mMultiVideo = mRenderEntity->findComponent<RenderMultiVideoComponentInstance>();
+		auto* multi_video = mMultiVideo;
+		if (multi_video != nullptr && multi_video->getMode() == EVideoMode::Raster)
+		{
+			auto output = writeResource(mFrameGraph, resources, "Video", multi_video->getOutputTexture());
+			mFrameGraph.addPass("Video", {}, { output }, [multi_video]()
+			{
 				multi_video->draw();
+			});
+		}
 
-			// Render stencil geometry to stencil target
-			if (mStencilTarget != nullptr)
+		// Render stencil geometry to stencil target
+		std::vector<std::string> color_reads = { graph::shadowMaps };
+		if (mStencilTarget != nullptr)
+		{
+			auto output = writeResource(mFrameGraph, resources, "Stencil", mStencilTarget->getColorTexture());
+			mFrameGraph.addPass("Stencil", {}, { output }, [this]()
 			{
-				auto stencil_mask = mRenderService->getRenderMask("Stencil");
+				auto& cam = mCameraEntity->getComponent<CameraComponentInstance>();
 				mStencilTarget->beginRendering();
-				mRenderService->renderObjects(*mStencilTarget, cam, render_comps, stencil_mask);
+				mRenderService->renderObjects(*mStencilTarget, cam, mWorldRegistry.getRenderables(mStencilMask), mStencilMask);
 				mStencilTarget->endRendering();
-			}
+			});
+		}
+
+		// Offscreen color pass -> Render all available geometry to the color texture bound to the render target.
+		// The composite video component samples the video and stencil textures.
+		auto* composite_video = mRenderEntity->findComponentByID<RenderToTextureComponentInstance>("CompositeVideo");
+		if (composite_video != nullptr)
+		{
+			std::vector<const Texture2D*> textures;
+			getSampledTextures(composite_video->getMaterialInstance(), textures);
+			auto names = readResources(mFrameGraph, resources, textures);
+			color_reads.insert(color_reads.end(), names.begin(), names.end());
+		}
 
-			// Offscreen color pass -> Render all available geometry to the color texture bound to the render target.
+		auto color_output = writeResource(mFrameGraph, resources, "Color", mColorTarget->getColorTexture());
+		mFrameGraph.addPass("Color", color_reads, { color_output }, [this, composite_video]()
+		{
+			auto& cam = mCameraEntity->getComponent<CameraComponentInstance>();
 			mColorTarget->beginRendering();
 			{
-				auto* composite_video = mRenderEntity->findComponentByID<RenderToTextureComponentInstance>("CompositeVideo");
 				if (composite_video != nullptr)
 				{
 					const auto size = static_cast<glm::vec2>(mColorTarget->getBufferSize());
@@ -119,72 +553,118 @@ namespace nap
 					mRenderService->renderObjects(*mColorTarget, proj_matrix, glm::identity<glm::mat4>(), { composite_video }, std::bind(&sorter::sortObjectsByDepth, std::placeholders::_1, std::placeholders::_2));
 				}
 
-				auto mask = mRenderService->getRenderMask("Default");
-				mRenderService->renderObjects(*mColorTarget, cam, render_comps, std::bind(&sorter::sortObjectsByZ, std::placeholders::_1), (mask != 0) ? mask : mask::all);
+				mRenderService->renderObjects(*mColorTarget, cam, mWorldRegistry.getRenderables(mDefaultMask), std::bind(&sorter::sortObjectsByZ, std::placeholders::_1), mDefaultMask);
 
 				if (mShowLocators)
 					mRenderAdvancedService->renderLocators(*mColorTarget, cam, true);
 			}
 			mColorTarget->endRendering();
+		});
 
-			// DOF
-			auto* dof = mRenderEntity->findComponent<RenderDOFComponentInstance>();
-			if (dof != nullptr)
+		// DOF -> The intermediate texture is transient, the scenes share it with the bloom texture which is written after the DOF.
+		// See RenderDOFComponent::mIntermediateTexture.
+		auto* dof = mRenderEntity->findComponent<RenderDOFComponentInstance>();
+		if (dof != nullptr)
+		{
+			auto input = readResources(mFrameGraph, resources, { &dof->getComponent<RenderDOFComponent>()->mInputTarget->getColorTexture() });
+			auto intermediate = writeResource(mFrameGraph, resources, "DOFIntermediate", dof->getIntermediateTexture());
+			auto output = writeResource(mFrameGraph, resources, "DOF", dof->getOutputTexture());
+			mFrameGraph.addPass("DOF", input, { intermediate, output }, [dof]()
+			{
 				dof->draw();
-
-			// Offscreen contrast pass -> Use previous `ColorTexture` as input, `ColorTextureFX` as output.
-			// Input and output resources of these operations are described in JSON in their appropriate components.
-			auto* change_color = mRenderEntity->findComponentByID<RenderToTextureComponentInstance>("ChangeColor"); assert(change_color != nullptr);
-			change_color->draw();
-
-			// Offscreen bloom pass -> Use `ColorTextureFX` as input and output.
-			// This is fine as the bloom component blits the input to internally managed render targets on which the effect is applied.
-			// the effect result is blitted to the output texture. The effect therefore does not write to itself.
-			mRenderEntity->getComponent<RenderBloomComponentInstance>().draw();
-
-			// End headless recording
-			mRenderService->endHeadlessRecording();
+			});
 		}
 
-		// Begin recording the render commands for the main render window
-		if (mRenderService->beginRecording(*mRenderWindow))
+		// Offscreen contrast pass -> Use previous `ColorTexture` as input, `ColorTextureFX` as output.
+		// Input and output resources of these operations are described in JSON in their appropriate components.
+		// Optional, the post-process material applies the same adjustment to the blurred bloom when its 'CHANGE_COLOR' constant is set.
+		auto* change_color = mRenderEntity->findComponentByID<RenderToTextureComponentInstance>("ChangeColor");
+		if (change_color != nullptr)
 		{
-			// Begin render pass
-			mRenderWindow->beginRendering();
+			std::vector<const Texture2D*> textures;
+			getSampledTextures(change_color->getMaterialInstance(), textures);
+			auto inputs = readResources(mFrameGraph, resources, textures);
+			auto output = writeResource(mFrameGraph, resources, "ChangeColor", change_color->getOutputTexture());
+			mFrameGraph.addPass("ChangeColor", inputs, { output }, [change_color]()
+			{
+				change_color->draw();
+			});
+		}
 
-			// Get Perspective camera to render with
-			auto& cam = mRenderCameraEntity->getComponent<CameraComponentInstance>();
+		// Offscreen bloom pass -> Use `ColorTextureFX` as input and output.
+		// This is fine as the bloom component blits the input to internally managed render targets on which the effect is applied.
+		// the effect result is blitted to the output texture. The effect therefore does not write to itself.
+		// Applied in place the pass writes a new version of its input resource, otherwise it writes the 'Bloom' resource.
+		auto* bloom = mRenderEntity->findComponent<RenderBloomComponentInstance>();
+		if (bloom != nullptr)
+		{
+			auto* bloom_resource = bloom->getComponent<RenderBloomComponent>();
+			auto input = readResources(mFrameGraph, resources, { bloom_resource->mInputTexture.get() });
+			auto output = bloom_resource->mInputTexture == bloom_resource->mOutputTexture ? input.front() :
+				writeResource(mFrameGraph, resources, "Bloom", *bloom_resource->mOutputTexture);
+			mFrameGraph.addPass("Bloom", input, { output }, [bloom]()
+			{
+				bloom->draw();
+			});
+		}
 
-			// Get composite component responsible for rendering final texture
-			auto* composite_comp = mRenderEntity->findComponentByID<RenderToTextureComponentInstance>("BlendTogether");
-			if (composite_comp != nullptr)
+		// The window pass consumes the final textures, passes that do not contribute to these are culled
+		std::vector<const Texture2D*> outputs;
+		mCompositeComp = mRenderEntity->findComponentByID<RenderToTextureComponentInstance>("BlendTogether");
+		if (mCompositeComp != nullptr)
+		{
+			getSampledTextures(mCompositeComp->getMaterialInstance(), outputs);
+		}
+		else
+		{
+			for (auto* comp : mWarpRegistry.getRenderables())
 			{
-				// Render composite component
-				// The nap::RenderToTextureComponentInstance transforms a plane to match the window dimensions and applies the texture to it.
-				mRenderService->renderObjects(*mRenderWindow, cam, { composite_comp });
+				if (comp->get_type().is_derived_from(RTTI_OF(RenderableMeshComponentInstance)))
+					getSampledTextures(static_cast<RenderableMeshComponentInstance*>(comp)->getMaterialInstance(), outputs);
 			}
-			else if (mWarpEntity != nullptr)
-			{
-				// Get composite component responsible for rendering final texture
-				std::vector<RenderableComponentInstance*> render_comps;
-				mWarpEntity->getComponentsOfTypeRecursive<RenderableComponentInstance>(render_comps);
+		}
 
-				// Render warp components
-				mRenderService->renderObjects(*mRenderWindow, cam, { render_comps });	
-			}
+		for (const auto& name : readResources(mFrameGraph, resources, outputs))
+			mFrameGraph.markOutput(name);
 
-			// Draw GUI elements
-			mGuiService->draw();
+		if (!mFrameGraph.compile(error))
+			return false;
 
-			// Stop render pass
-			mRenderWindow->endRendering();
+		// Measure every scheduled pass on the GPU
+		mPassMarkers.clear();
+		for (const auto* pass : mFrameGraph.getSchedule())
+			mPassMarkers.emplace(pass, mProfiler->registerMarker(pass->mName, Profiler::EDomain::GPU));
 
-			// End recording
-			mRenderService->endRecording();
-		}
+		// Report
+		for (const auto* pass : mFrameGraph.getCulledPasses())
+			nap::Logger::info("Frame graph: culled pass '%s', its output is never used", pass->mName.c_str());
 
-		// Proceed to next frame
-		mRenderService->endFrame();
+		for (const auto& candidate : mFrameGraph.getAliasCandidates())
+			nap::Logger::info("Frame graph: '%s' and '%s' are never alive at the same time and can share a texture", candidate.first.c_str(), candidate.second.c_str());
+
+		return true;
+    }
+
+
+    void LovePostersApp::onResourcesLoaded()
+    {
+		// Entity and component instances are recreated on reload
+		mWorldRegistry.setRoot(mWorldEntity.get());
+		mWarpRegistry.setRoot(mWarpEntity.get());
+
+		// Lights and casters are recreated, always render the shadows of the next frame
+		mLights.clear();
+		mScene->getRootEntity().getComponentsOfTypeRecursive<LightComponentInstance>(mLights);
+		mSpriteVolumes.clear();
+		mScene->getRootEntity().getComponentsOfTypeRecursive<PointSpriteVolumeInstance>(mSpriteVolumes);
+		mShadowCache.invalidate();
+
+		utility::ErrorState error;
+		if (!initFrameGraph(error))
+			nap::Logger::error("Unable to rebuild frame graph: %s", error.toString().c_str());
+
+		// Reloaded materials and meshes require new pipelines
+		mPrewarmRequested = true;
     }
 
 
@@ -212,7 +692,8 @@ namespace nap
 
 				case nap::EKeyCode::KEY_f:
 				{
-					mRenderWindow->toggleFullscreen();
+					if (mRenderWindow != nullptr)
+						mRenderWindow->toggleFullscreen();
 					break;
 				}
 
@@ -271,12 +752,15 @@ namespace nap
 
     void LovePostersApp::update(double deltaTime)
     {
+		ProfileScope profile_scope(mUpdateMarker);
+
 		// Use a default input router to forward input events (recursively) to all input components in the scene
 		// This is explicit because we don't know what entity should handle the events from a specific window.
 		nap::DefaultInputRouter input_router(true);
-		mInputService->processWindowEvents(*mRenderWindow, input_router, { &mScene->getRootEntity() });
+		if (mRenderWindow != nullptr)
+			mInputService->processWindowEvents(*mRenderWindow, input_router, { &mScene->getRootEntity() });
 
-		if (mShowGUI)
+		if (mShowGUI && !mBenchmark.mEnabled)
 		{
 			for (auto& gui : mAppGUIs)
 				gui->draw(deltaTime);
@@ -16,13 +16,38 @@
 #include <entity.h>
 #include <app.h>
 #include <appgui.h>
+#include <rendertotexturecomponent.h>
+#include <chrono>
 
 #include "audiodevicesettingsgui.h"
+#include "framegraph.h"
+#include "renderregistry.h"
+#include "profiler.h"
+#include "shadowcache.h"
+#include "rendermultivideocomponent.h"
+#include "pointspritevolume.h"
 
 namespace nap 
 {
 	using namespace rtti;
 
+	/**
+	 * Offline benchmark settings, parsed from the command line in main.cpp.
+	 * When enabled main.cpp loads a headless copy of the scene without a window. The app renders the headless passes only,
+	 * advances all module components with a fixed time step and quits after the given number of frames, printing frame time statistics.
+	 */
+	struct BenchmarkSettings
+	{
+		bool			mEnabled = false;					///< If benchmark mode is enabled
+		std::string		mProjectFile;						///< Headless project to initialize the engine with, benchmark.json next to the executable when empty
+		std::string		mDataFile;							///< Scene to load, project default when empty
+		int				mFrames = 600;						///< Number of frames to render
+		double			mTimeStep = 1.0 / 60.0;				///< Fixed time step in seconds
+		std::string		mOutputFile;						///< CSV file to write the statistics to, optional
+		std::string		mCaptureFile;						///< Image file to write the final texture to, optional
+		std::string		mCaptureSource = "color";			///< Texture to capture: 'color', 'bloom' or the ID of a texture
+	};
+
     /**
      * LovePostersApp
      */
@@ -68,9 +93,51 @@ namespace nap
 		 * Called when the app is shutting down after quit() has been invoked
 		 * @return the application exit code, this is returned when the main loop is exited
          */
-		int shutdown() override { return 0; }
+		int shutdown() override { return mExitCode; }
+
+		/**
+		 * Enables benchmark mode, call before the app is initialized.
+		 * @param settings the benchmark settings
+		 */
+		void setBenchmarkSettings(const BenchmarkSettings& settings) { mBenchmark = settings; }
 
     private:
+		/**
+		 * Declares the headless render passes and the resources they read and write, and compiles the frame graph.
+		 * @param error contains the error if the graph is invalid
+		 * @return if the frame graph compiled successfully
+		 */
+		bool initFrameGraph(utility::ErrorState& error);
+
+		/**
+		 * Called after resources are (re)loaded, invalidates the cached render lists and rebuilds the frame graph.
+		 */
+		void onResourcesLoaded();
+		nap::Slot<> mResourcesLoadedSlot = { this, &LovePostersApp::onResourcesLoaded };
+
+		/**
+		 * Records and submits one headless frame with every renderable visible, creating all pipelines
+		 * the frame graph passes require before they are first used. Hidden renderables are hidden again afterwards.
+		 * Called before the first frame and after resources are reloaded.
+		 */
+		void prewarm();
+
+		/**
+		 * Records the frame time, requests the capture after the last frame and quits when done. Called at the end of every frame.
+		 * Exactly the requested number of frames is recorded and measured, frames that wait for the capture record nothing.
+		 */
+		void advanceBenchmark();
+
+		/**
+		 * Prints the frame time and profiler statistics of the benchmark.
+		 */
+		void reportBenchmark();
+
+		/**
+		 * Downloads the capture texture and writes it to disk when available.
+		 */
+		void requestCapture();
+
         ResourceManager*			mResourceManager = nullptr;			///< Manages all the loaded data
 		RenderService*				mRenderService = nullptr;			///< Render Service that handles render calls
 		RenderAdvancedService*		mRenderAdvancedService = nullptr;	///< Render Service that handles render calls
@@ -92,6 +159,38 @@ namespace nap
 
 		std::vector<ObjectPtr<AppGUI>> mAppGUIs;						///< AppGUIs
 
+		FrameGraph mFrameGraph;											///< Headless render passes of a frame
+		RenderRegistry mWorldRegistry;									///< Renderable components of the world entity, bucketed by mask
+		RenderRegistry mWarpRegistry;									///< Renderable components of the warp entity
+		ShadowCache mShadowCache;										///< Skips shadow rendering when lights and casters are unchanged
+		std::vector<LightComponentInstance*> mLights;					///< All lights in the scene
+		RenderToTextureComponentInstance* mCompositeComp = nullptr;		///< Composites the final textures to the window, optional
+		RenderMultiVideoComponentInstance* mMultiVideo = nullptr;		///< Mixes the video layers, optional
+		std::vector<PointSpriteVolumeInstance*> mSpriteVolumes;		///< Point sprite volumes, simulated in the compute recording
+
+		Profiler* mProfiler = nullptr;									///< Collects CPU and GPU timings
+		ProfileMarker mUpdateMarker;									///< CPU time of update()
+		ProfileMarker mRenderMarker;									///< CPU time of render()
+		ProfileMarker mWindowMarker;									///< GPU time of the window pass
+		std::unordered_map<const FrameGraph::Pass*, ProfileMarker> mPassMarkers;	///< GPU time per frame graph pass
+		FrameGraph::PassObserver mBeginPass;							///< Starts measuring a frame graph pass
+		FrameGraph::PassObserver mEndPass;								///< Stops measuring a frame graph pass
+
+		bool mPrewarmRequested = true;									///< Prewarm pipelines before the next frame
+
+		RenderMask mShadowMask = 0;										///< Shadow render mask
+		RenderMask mStencilMask = 0;									///< Stencil render mask
+		RenderMask mDefaultMask = 0;									///< Default render mask, all when not available
+
+		BenchmarkSettings mBenchmark;									///< Benchmark settings
+		int mBenchmarkFrame = 0;										///< Number of recorded benchmark frames
+		int mFlushFrames = 0;											///< Number of frames rendered after the benchmark, waiting for the capture
+		std::vector<float> mFrameTimes;									///< Benchmark frame times in milliseconds
+		std::chrono::steady_clock::time_point mLastFrameTime;			///< End of the previous benchmark frame, or of the prewarm before the first
+		bool mCaptureRequested = false;									///< If the capture download is requested
+		bool mCaptureDone = false;										///< If the capture download completed
+		int mExitCode = 0;												///< Application exit code
+
 		bool mShowGUI = false;
 		bool mShowCursor = false;
 		bool mShowLocators = false;
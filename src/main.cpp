@@ -2,11 +2,138 @@
 //
 // Local Includes
 #include "lovepostersapp.h"
+#include "shadercache.h"
+#include "benchmarkscene.h"
 
 // Nap includes
 #include <apprunner.h>
 #include <nap/logger.h>
 #include <guiappeventhandler.h>
+#include <utility/fileutils.h>
+
+// External Includes
+#include <string>
+#include <functional>
+
+/**
+ * Parses the benchmark command line arguments:
+ *
+ *	--benchmark				render headless with a fixed time step and quit when done
+ *	--project <file>		headless project to initialize the engine with, default benchmark.json next to the executable
+ *	--data <file>			scene to load, for example data/lovetransmission1.json, default the data of the project
+ *	--frames <count>		number of frames to render, default 600
+ *	--delta <seconds>		fixed time step, default 1/60
+ *	--output <file>			write the timing statistics to a CSV file
+ *	--capture <file>		write the final texture to an image file
+ *	--capture-source <id>	texture to capture: 'color', 'bloom' or the ID of a texture
+ *
+ * @return if the arguments are valid
+ */
+static bool parseBenchmarkArguments(int argc, char* argv[], nap::BenchmarkSettings& outSettings, nap::utility::ErrorState& error)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string arg = argv[i];
+		if (arg == "--benchmark")
+		{
+			outSettings.mEnabled = true;
+			continue;
+		}
+
+		// All other arguments require a value
+		if (arg.rfind("--", 0) != 0)
+			continue;
+
+		if (!error.check(i + 1 < argc, "missing value for argument: %s", arg.c_str()))
+			return false;
+
+		const std::string value = argv[++i];
+		if (arg == "--project")
+			outSettings.mProjectFile = value;
+		else if (arg == "--data")
+			outSettings.mDataFile = value;
+		else if (arg == "--frames")
+			outSettings.mFrames = std::stoi(value);
+		else if (arg == "--delta")
+			outSettings.mTimeStep = std::stod(value);
+		else if (arg == "--output")
+			outSettings.mOutputFile = value;
+		else if (arg == "--capture")
+			outSettings.mCaptureFile = value;
+		else if (arg == "--capture-source")
+			outSettings.mCaptureSource = value;
+		else
+			nap::Logger::warn("unknown argument: %s", arg.c_str());
+	}
+
+	if (!error.check(outSettings.mFrames > 0, "frame count must be greater than 0"))
+		return false;
+
+	if (!error.check(outSettings.mTimeStep > 0.0, "time step must be greater than 0"))
+		return false;
+
+	return true;
+}
+
+
+/**
+ * Runs the benchmark without a window, in place of the app runner.
+ * The engine is initialized with the headless project, which forbids render windows, and only the benchmark scene is loaded.
+ * Render windows are stripped from a copy of the scene, the app never creates one and only records headless passes.
+ * @return the exit code of the app, -1 if the benchmark can't be started
+ */
+static int runBenchmark(nap::Core& core, const nap::BenchmarkSettings& settings, nap::utility::ErrorState& error)
+{
+	// Resolve the files before the working directory changes
+	const std::string exe_dir = nap::utility::getExecutableDir();
+	const std::string project_file = settings.mProjectFile.empty() ?
+		nap::utility::joinPath({ exe_dir, "benchmark.json" }) : nap::utility::getAbsolutePath(settings.mProjectFile);
+	std::string data_file = settings.mDataFile.empty() ? std::string() : nap::utility::getAbsolutePath(settings.mDataFile);
+	nap::BenchmarkSettings app_settings = settings;
+	for (auto* file : { &app_settings.mOutputFile, &app_settings.mCaptureFile })
+	{
+		if (!file->empty())
+			*file = nap::utility::getAbsolutePath(*file);
+	}
+
+	// Initialize engine and services
+	if (!core.initializeEngine(project_file, nap::ProjectInfo::EContext::Deployment, error))
+		return -1;
+
+	nap::Core::ServicesHandle services = core.initializeServices(error);
+	if (services == nullptr)
+		return -1;
+
+	// Paths in the scene are relative to the data directory
+	nap::utility::changeDir(core.getProjectInfo()->getDataDirectory());
+	if (data_file.empty())
+		data_file = core.getProjectInfo()->getDataFile();
+
+	// Load the headless copy of the benchmark scene only
+	const std::string scene_file = nap::utility::joinPath({ exe_dir, "cache", "benchmark", nap::utility::getFileName(data_file) });
+	if (!nap::benchmarkscene::write(data_file, scene_file, settings.mCaptureFile.empty() ? std::string() : settings.mCaptureSource, error))
+		return -1;
+
+	nap::Logger::info("Benchmark: loading %s", data_file.c_str());
+	if (!core.getResourceManager()->loadFile(scene_file, error))
+		return -1;
+
+	nap::LovePostersApp app(core);
+	app.setBenchmarkSettings(app_settings);
+	if (!error.check(app.init(error), "unable to initialize application"))
+		return -1;
+
+	// Run until the benchmark quits, there are no window or input events to process
+	std::function<void(double)> update_call = std::bind(&nap::LovePostersApp::update, &app, std::placeholders::_1);
+	core.start();
+	while (!app.shouldQuit())
+	{
+		core.update(update_call);
+		app.render();
+	}
+	return app.shutdown();
+}
+
 
 // Main loop
 int main(int argc, char *argv[])
@@ -14,12 +141,43 @@ int main(int argc, char *argv[])
     // Create core
     nap::Core core;
 
+	// Parse benchmark settings
+    nap::utility::ErrorState error;
+	nap::BenchmarkSettings benchmark;
+	try
+	{
+		if (!parseBenchmarkArguments(argc, argv, benchmark, error))
+		{
+			nap::Logger::fatal("error: %s", error.toString().c_str());
+			return -1;
+		}
+	}
+	catch (const std::exception& e)
+	{
+		nap::Logger::fatal("error: invalid argument: %s", e.what());
+		return -1;
+	}
+
+	// Persist compiled shaders and pipelines next to the app, before the render service is created
+	const std::string exe_dir = nap::utility::getExecutableDir();
+	nap::utility::ErrorState cache_error;
+	if (!nap::shadercache::enable(nap::utility::joinPath({ exe_dir, "cache", "shaders" }), nap::utility::joinPath({ exe_dir, "data", "shaders" }), cache_error))
+		nap::Logger::warn("Shader cache disabled: %s", cache_error.toString().c_str());
+
+	// Render headless
+	if (benchmark.mEnabled)
+	{
+		const int exit_code = runBenchmark(core, benchmark, error);
+		if (error.hasErrors())
+			nap::Logger::fatal("error: %s", error.toString().c_str());
+		return exit_code;
+	}
+
     // Create the application runner, based on the app to run
 	// and event handler that is used to forward information into the app.
     nap::AppRunner<nap::LovePostersApp, nap::GUIAppEventHandler> app_runner(core);
 
     // Start running
-    nap::utility::ErrorState error;
     if (!app_runner.start(error))
     {
         nap::Logger::fatal("error: %s", error.toString().c_str());
@@ -29,4 +187,3 @@ int main(int argc, char *argv[])
     // Return if the app ran successfully
     return app_runner.exitCode();
 }
-
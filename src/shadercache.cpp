@@ -0,0 +1,121 @@
+// Local Includes
+#include "shadercache.h"
+
+// External Includes
+#include <nap/logger.h>
+#include <utility/stringutils.h>
+#include <filesystem>
+#include <fstream>
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+namespace nap
+{
+	namespace shadercache
+	{
+		static constexpr uint64 fnvOffset = 14695981039346656037ull;
+		static constexpr uint64 fnvPrime = 1099511628211ull;
+		static constexpr const char* hashFile = "shaders.hash";
+
+		static void hashBytes(const char* data, size_t size, uint64& hash)
+		{
+			for (size_t i = 0; i < size; i++)
+			{
+				hash ^= static_cast<uint8>(data[i]);
+				hash *= fnvPrime;
+			}
+		}
+
+
+		/**
+		 * Sets an environment variable when it is not set already
+		 */
+		static void setDefaultEnv(const char* name, const std::string& value)
+		{
+			if (std::getenv(name) != nullptr)
+				return;
+#ifdef _WIN32
+			_putenv_s(name, value.c_str());
+#else
+			setenv(name, value.c_str(), 0);
+#endif
+		}
+
+
+		uint64 hashDirectory(const std::string& directory)
+		{
+			std::error_code error;
+			if (!std::filesystem::is_directory(directory, error))
+				return 0;
+
+			// Sort, iteration order is not defined
+			std::vector<std::filesystem::path> files;
+			for (const auto& entry : std::filesystem::recursive_directory_iterator(directory, error))
+			{
+				if (entry.is_regular_file())
+					files.emplace_back(entry.path());
+			}
+			std::sort(files.begin(), files.end());
+
+			uint64 hash = fnvOffset;
+			std::vector<char> buffer;
+			for (const auto& file : files)
+			{
+				const std::string name = std::filesystem::relative(file, directory, error).generic_string();
+				hashBytes(name.data(), name.size(), hash);
+
+				std::ifstream stream(file, std::ios::in | std::ios::binary);
+				buffer.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+				hashBytes(buffer.data(), buffer.size(), hash);
+			}
+			return hash;
+		}
+
+
+		bool enable(const std::string& cacheDirectory, const std::string& shaderDirectory, utility::ErrorState& errorState)
+		{
+			std::error_code error;
+			std::filesystem::create_directories(cacheDirectory, error);
+			if (!errorState.check(!error, "Unable to create shader cache directory %s: %s", cacheDirectory.c_str(), error.message().c_str()))
+				return false;
+
+			// Clear the cache when the shaders changed
+			const std::string hash = utility::stringFormat("%016llx", static_cast<unsigned long long>(hashDirectory(shaderDirectory)));
+			const auto hash_path = std::filesystem::path(cacheDirectory) / hashFile;
+			std::string cached_hash;
+			{
+				std::ifstream stream(hash_path);
+				std::getline(stream, cached_hash);
+			}
+
+			if (cached_hash != hash)
+			{
+				for (const auto& entry : std::filesystem::directory_iterator(cacheDirectory, error))
+					std::filesystem::remove_all(entry.path(), error);
+
+				std::ofstream stream(hash_path, std::ios::out | std::ios::trunc);
+				stream << hash << "\n";
+				nap::Logger::info("Shader cache invalidated, shaders changed: %s", hash.c_str());
+			}
+
+			// Mesa (RADV, ANV)
+			const std::string cache_path = std::filesystem::absolute(cacheDirectory, error).string();
+			setDefaultEnv("MESA_SHADER_CACHE_DIR", cache_path);
+			setDefaultEnv("MESA_SHADER_CACHE_MAX_SIZE", "1G");
+
+			// NVIDIA
+			setDefaultEnv("__GL_SHADER_DISK_CACHE", "1");
+			setDefaultEnv("__GL_SHADER_DISK_CACHE_PATH", cache_path);
+			setDefaultEnv("__GL_SHADER_DISK_CACHE_SIZE", "1073741824");
+			setDefaultEnv("__GL_SHADER_DISK_CACHE_SKIP_CLEANUP", "1");
+
+			// AMD (AMDVLK)
+			setDefaultEnv("AMD_VK_USE_PIPELINE_CACHE", "true");
+			setDefaultEnv("AMD_VK_PIPELINE_CACHE_PATH", cache_path);
+
+			nap::Logger::info("Shader cache: %s", cache_path.c_str());
+			return true;
+		}
+	}
+}
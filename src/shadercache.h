@@ -0,0 +1,38 @@
+#pragma once
+
+// External Includes
+#include <utility/errorstate.h>
+#include <nap/numeric.h>
+#include <string>
+
+namespace nap
+{
+	namespace shadercache
+	{
+		/**
+		 * Computes a 64 bit FNV-1a hash of the names and contents of all files in the given directory, recursively.
+		 * @param directory the directory to hash
+		 * @return the hash, 0 if the directory does not exist
+		 */
+		uint64 hashDirectory(const std::string& directory);
+
+		/**
+		 * Points the persistent shader and pipeline caches of the Vulkan drivers to the given directory.
+		 * Must be called before the render service is initialized, the drivers read their settings on instance creation.
+		 *
+		 * NAP compiles GLSL and creates graphics pipelines internally, without a VkPipelineCache. The compute pipelines of
+		 * the module are persisted by the nap::PipelineCache, graphics pipelines rely on the drivers: they cache the compiled
+		 * pipelines themselves, keyed by SPIR-V and pipeline state, including specialization constants. By default these
+		 * caches live in a user directory that does not survive a re-imaged or cleaned installation and is capped in size.
+		 *
+		 * The cache is cleared when the hash of the shader directory changes, stale entries are never loaded.
+		 * Variables that are already set in the environment are left untouched.
+		 *
+		 * @param cacheDirectory directory to store the driver caches in, created when it doesn't exist
+		 * @param shaderDirectory directory that contains the GLSL sources of the app
+		 * @param errorState contains the error if the cache directory can't be created
+		 * @return if the cache is enabled
+		 */
+		bool enable(const std::string& cacheDirectory, const std::string& shaderDirectory, utility::ErrorState& errorState);
+	}
+}